@@ -0,0 +1,41 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+/**
+ * Counts the heap allocations of the program, for checking that the game loop does not allocate once warm.
+ *
+ * Only compiled in with the ARKANOID_COUNT_ALLOCATIONS build option (cmake -DARKANOID_COUNT_ALLOCATIONS=ON). The
+ * global operator new is then replaced by one that counts before allocating with malloc, and the allocator of SDL
+ * (SDL_malloc, SDL_calloc, SDL_realloc, used by SDL_ttf as well) is wrapped the same way. Allocations of all threads
+ * are counted. Direct malloc calls of other libraries, FreeType's for one, are not seen.
+ * Without the option the counter stays at 0 and nothing is replaced.
+ *
+ * Functions:
+ *  - bool allocation_counting_enabled(): whether the counter is compiled in.
+ *  - void install_allocation_counter(): wrap the allocator of SDL.
+ *  - uint64_t get_allocation_count(): allocations so far.
+ *
+ */
+
+/**
+ * Whether the counter was compiled in with ARKANOID_COUNT_ALLOCATIONS.
+ */
+bool allocation_counting_enabled();
+
+/**
+ * Wrap the allocator of SDL to count its allocations too. Call first thing in main, before SDL allocates anything,
+ * memory SDL allocated before is still freed correctly. Does nothing without ARKANOID_COUNT_ALLOCATIONS.
+ */
+void install_allocation_counter();
+
+/**
+ * Get the number of allocations of all threads so far, 0 without ARKANOID_COUNT_ALLOCATIONS.
+ *
+ * Returns:
+ * uint64_t: allocations through operator new and the allocator of SDL, reallocations included.
+ */
+uint64_t get_allocation_count();
+
+#endif // !ALLOCATION_COUNTER_H
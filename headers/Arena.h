@@ -0,0 +1,85 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+/**
+ * Monotonic arena, a std::pmr::memory_resource handing out memory by bumping an offset into a single block.
+ *
+ * Deallocation does nothing, the memory comes back all at once by reset() or by destroying the arena. Data that all
+ * dies together (the bricks of a level, the commands of a frame) lives in std::pmr containers on an arena, so it is
+ * allocated without allocator bookkeeping and torn down by freeing the block.
+ * What does not fit into the block goes to a std::pmr::monotonic_buffer_resource on the heap. reset() then grows
+ * the block to what the cycle needed, so an arena reset every frame stops touching the heap after the first frames.
+ * An arena filled once, whose size is known beforehand, gets its block from reserve() before it is filled.
+ * An arena is not thread safe, it belongs to the thread filling it.
+ *
+ * std::unique_ptr<std::byte[]> m_block: the block, null until something needed it.
+ * size_t m_capacity: size of the block.
+ * size_t m_used: bytes of the block handed out, with their alignment padding.
+ * size_t m_overflow_bytes: bytes handed out by m_overflow since the last reset.
+ * std::pmr::monotonic_buffer_resource m_overflow: heap memory for what did not fit into the block.
+ *
+ * Public Methods:
+ *  - void reset(): take back everything handed out, growing the block if it overflowed.
+ *  - void reserve(): make the block at least a given size before anything is handed out.
+ *  - size_t used(): bytes handed out since the last reset.
+ *  - size_t capacity(): size of the block.
+ *
+ */
+class Arena : public std::pmr::memory_resource
+{
+    std::unique_ptr<std::byte[]> m_block;
+    size_t m_capacity = 0;
+    size_t m_used = 0;
+    size_t m_overflow_bytes = 0;
+    std::pmr::monotonic_buffer_resource m_overflow;
+
+public:
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * Constructor for the Arena class.
+     *
+     * Params:
+     * size_t initial_capacity: size of the block. Default is 0, everything goes to the heap until the first reset().
+     */
+    Arena(size_t initial_capacity = 0);
+
+    /**
+     * Take back everything handed out, all memory of the arena may be handed out again. If the block overflowed since
+     * the last reset it is replaced by one large enough for all of it.
+     */
+    void reset();
+
+    /**
+     * Make the block at least the given size, for an arena whose contents are known before it is filled. Does
+     * nothing once something was handed out since the last reset, that memory may still live in the block.
+     *
+     * Params:
+     * size_t capacity: bytes the block should hold.
+     */
+    void reserve(size_t capacity);
+
+    /**
+     * Get the bytes handed out since the last reset, block and heap.
+     */
+    size_t used() const;
+
+    /**
+     * Get the size of the block.
+     */
+    size_t capacity() const;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void* memory, size_t bytes, size_t alignment) override;
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+#endif // !ARENA_H
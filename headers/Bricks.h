@@ -1,67 +1,176 @@
 #ifndef BRICKS_H
 #define BRICKS_H
 
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
 #include <vector>
 
 #include "SDL.h"
 
 #include "Brick.h"
 #include "BricksLayout.h"
+#include "Arena.h"
 
 /**
- * Bricks class holds a vector of bricks. It is responsible for drawing the bricks on the screen.
- * It also keeps track of the number of bricks left on the screen. 
- * It also provides methods to be an iterable over the vector of bricks.
- * 
- * std::vector<Brick> m_bricks: vector of bricks.
+ * Bricks class holds the bricks of a level. It is responsible for drawing the bricks on the screen and for finding
+ * the brick the ball hits. It also keeps track of the number of bricks left on the screen.
+ *
+ * The bricks are stored in square chunks of chunk_size pixels, a brick belongs to the chunk of its top left corner.
+ * Every chunk is kept packed (varint deltas, about 8 bytes a brick instead of sizeof(Brick)), and only the chunks
+ * around the view and the ball are decoded into Brick objects: page() decodes those and drops the decoded bricks of
+ * the others, the packed form never changes as a hit only clears the brick's bit in a visibility bitset. Drawing
+ * and hit tests only touch the chunks the rectangle overlaps, decoding a chunk that is not hot on demand, so
+ * correctness never depends on paging. With page() called every frame the decoded bricks, and the work per frame,
+ * scale with the visible area instead of the level, the level itself costs its packed bytes and a bit per brick.
+ * Bricks are numbered in the order of the layout, which also decides which of two bricks hit at once is destroyed.
+ * Everything the level keeps lives in std::pmr containers on the level's own Arena, the layout's bricks and the
+ * buffers of the construction on a scratch arena dropped when it is done. The level arena's block is reserved for
+ * the packed level before it is filled, only the decoded buffers of page() go beyond it, to the arena's overflow.
+ * The bricks of a level are thus a few large blocks, allocated without per container bookkeeping and freed at once
+ * with the Bricks.
+ *
+ * Chunk: a chunk of the level, its containers on the level arena.
+ *  - int x, y: top left corner of the chunk.
+ *  - std::pmr::vector<uint8_t> packed: the bricks of the chunk in layout order, see pack().
+ *  - uint32_t count: number of bricks in the chunk.
+ *  - std::pmr::vector<Brick> bricks: the decoded bricks, empty when the chunk is cold.
+ *  - std::pmr::vector<uint32_t> indices: layout index of every decoded brick.
+ *  - bool hot: the bricks are decoded.
+ *  - uint64_t wanted: last page() that wanted the chunk hot.
+ *
+ * Arena m_arena: memory of everything below, declared first so it goes last.
+ * std::pmr::vector<Chunk> m_chunks: the chunks holding bricks.
+ * std::pmr::vector<int32_t> m_grid: index into m_chunks of every cell of the chunk grid, row by row, -1 for no bricks.
+ * int m_origin_x, m_origin_y: top left corner of the chunk grid, the top left corner of the level's bricks.
+ * int m_cols, m_rows: size of the chunk grid.
+ * int m_max_width, m_max_height: size of the largest brick, how far a brick reaches out of its chunk.
+ * uint32_t m_max_count: bricks of the fullest chunk, every decoded buffer holds as many so any spare fits any chunk.
+ * std::pmr::vector<uint8_t> m_visible: a bit per brick in layout order, set while the brick stands.
+ * std::pmr::vector<uint32_t> m_hot: the chunks that are decoded.
+ * std::pmr::vector<std::pmr::vector<Brick>> m_spare_bricks, std::pmr::vector<std::pmr::vector<uint32_t>> m_spare_indices:
+ *      buffers of evicted chunks, reused by the next decode(). Together with the hot chunks there are never more
+ *      buffers than the most chunks ever hot at once, so paging does not allocate once that many were decoded.
+ * size_t m_size: number of bricks of the level.
+ * uint64_t m_page: number of page() calls.
  * int m_brick_count: number of bricks left on the screen.
- * 
+ *
  * Public Methods:
  *  - Bricks(): constructor that takes a layout and generates bricks from it using its create_bricks method.
- *  - std::vector<Brick>& get_bricks(): returns the vector of bricks.
- *  - void draw(): draws the bricks on the screen.  
+ *  - std::vector<Brick> get_bricks(): returns a copy of all the bricks in layout order.
+ *  - size_t size(): number of bricks of the level.
+ *  - void draw(): draws the bricks on the screen.
+ *  - const Brick* hit(): destroys the brick a rectangle hits.
+ *  - void page(): keeps the chunks around the view and the ball decoded and drops the others.
  *  - int get_brick_count(): returns the number of bricks left on the screen.
  *  - void set_brick_count(): sets the number of bricks left on the screen.
- *  - void decrement_counter(): decrements the number of bricks left on the screen.
+ *  - void get_visibility(), set_visibility(): the visibility bits of the bricks.
  *  - void reset(): resets the bricks to be visible.
- * 
- * 
+ *  - size_t get_chunk_count(), get_hot_chunk_count(), get_resident_bytes(): paging statistics.
+ *
+ *
  */
 class Bricks
 {
-    std::vector<Brick> m_bricks;
+public:
+    static constexpr int chunk_size = 256;      // side of a chunk in pixels
+    static constexpr int hot_margin = 1;        // chunks around the view and the ball page() keeps hot
+
+private:
+    struct Chunk
+    {
+        int x = 0;
+        int y = 0;
+        std::pmr::vector<uint8_t> packed;
+        uint32_t count = 0;
+        std::pmr::vector<Brick> bricks;
+        std::pmr::vector<uint32_t> indices;
+        bool hot = false;
+        uint64_t wanted = 0;
+
+        explicit Chunk(std::pmr::memory_resource* arena): packed(arena), bricks(arena), indices(arena) {}
+    };
+
+    Arena m_arena;
+    std::pmr::vector<Chunk> m_chunks{&m_arena};
+    std::pmr::vector<int32_t> m_grid{&m_arena};
+    int m_origin_x = 0;
+    int m_origin_y = 0;
+    int m_cols = 0;
+    int m_rows = 0;
+    int m_max_width = 0;
+    int m_max_height = 0;
+    uint32_t m_max_count = 0;
+    std::pmr::vector<uint8_t> m_visible{&m_arena};
+    std::pmr::vector<uint32_t> m_hot{&m_arena};
+    std::pmr::vector<std::pmr::vector<Brick>> m_spare_bricks{&m_arena};
+    std::pmr::vector<std::pmr::vector<uint32_t>> m_spare_indices{&m_arena};
+    size_t m_size = 0;
+    uint64_t m_page = 0;
     int m_brick_count;
 
 public:
+    Bricks(const Bricks&) = delete;
+    Bricks& operator=(const Bricks&) = delete;
 
-    /** 
-     * Constructor for the Bricks class. It generates the bricks from the layout using its create_bricks method. 
-     * 
+    /**
+     * Constructor for the Bricks class. It generates the bricks from the layout using its create_bricks method and
+     * packs them into chunks, all of them cold.
+     *
      * Params:
      * BricksLayout& layout: layout of the bricks.
-     * 
+     *
      */
     Bricks(BricksLayout& layout);
 
     /**
-     * Get the reference to the vector of bricks.
-     * 
+     * Get a copy of all the bricks in layout order, with their current visibility. Decodes every chunk, meant for
+     * saving the level rather than for every frame.
+     *
      * Returns:
-     * std::vector<Brick>&: vector of bricks.
+     * std::vector<Brick>: vector of bricks.
      */
-    std::vector<Brick>& get_bricks();
+    std::vector<Brick> get_bricks() const;
 
     /**
-     * Draw the bricks on the screen.
-     * 
+     * Get the number of bricks of the level, standing or not.
+     */
+    size_t size() const;
+
+    /**
+     * Draw the standing bricks on the screen, only the chunks the screen overlaps are visited.
+     *
      * Params:
      * Screen& screen: screen to draw the bricks on.
      */
     void draw(Screen& screen);
 
+    /**
+     * Find the standing brick the rectangle intersects, the first in layout order if there are several, and destroy
+     * it: it is hidden and the number of bricks left is decremented.
+     *
+     * Params:
+     * const SDL_Rect& rect: the rectangle, the ball.
+     *
+     * Returns:
+     * const Brick*: the destroyed brick, valid until the next page(). Null if the rectangle hits no brick.
+     */
+    const Brick* hit(const SDL_Rect& rect);
+
+    /**
+     * Keep the chunks within hot_margin chunks of the view and of the focus rectangles decoded and drop the decoded
+     * bricks of all the others. Call once a frame.
+     *
+     * Params:
+     * const SDL_Rect& view: the part of the level on the screen.
+     * std::span<const SDL_Rect> focus: rectangles that will hit bricks soon, the ball.
+     */
+    void page(const SDL_Rect& view, std::span<const SDL_Rect> focus);
+
     /**
      * Get the number of bricks left on the screen.
-     * 
+     *
      * Returns:
      * int: number of bricks left on the screen.
      */
@@ -69,16 +178,28 @@ public:
 
     /**
      * Set the number of bricks left on the screen.
-     * 
+     *
      * Params:
      * int count: number of bricks left on the screen.
      */
     void set_brick_count(int count);
 
     /**
-     * Decrement the number of bricks left on the screen.
+     * Copy the visibility bits of the bricks, bit i % 8 of byte i / 8 is set while brick i stands.
+     *
+     * Params:
+     * uint8_t* bits: (size() + 7) / 8 bytes.
      */
-    void decrement_counter();
+    void get_visibility(uint8_t* bits) const;
+
+    /**
+     * Set the visibility of every brick from bits copied by get_visibility(). The number of bricks left is not
+     * changed, see set_brick_count().
+     *
+     * Params:
+     * const uint8_t* bits: (size() + 7) / 8 bytes.
+     */
+    void set_visibility(const uint8_t* bits);
 
     /**
      * Reset the bricks to be visible.
@@ -86,36 +207,55 @@ public:
     void reset();
 
     /**
-     * Begin iterator for the bricks.
-     * 
-     * Returns:
-     * auto: iterator to the beginning of the vector of bricks.
+     * Get the number of chunks holding bricks.
      */
-    std::vector<Brick>::iterator begin();
+    size_t get_chunk_count() const;
 
     /**
-     * Const begin iterator for the bricks.
-     * 
-     * Returns:
-     * auto: const iterator to the beginning of the vector of bricks.
+     * Get the number of decoded chunks.
      */
-    std::vector<Brick>::const_iterator cbegin() const;
+    size_t get_hot_chunk_count() const;
 
-    /** 
-     * End iterator for the bricks.
-     * 
-     * Returns:
-     * auto: iterator to the end of the vector of bricks.
+    /**
+     * Get the bytes the bricks take, all that was allocated from the level arena: packed chunks, decoded bricks and
+     * their spares, the grid and the visibility bits.
      */
-    std::vector<Brick>::iterator end();
+    size_t get_resident_bytes() const;
 
+private:
     /**
-     * Const end iterator for the bricks.
-     * 
+     * Get the cells of the chunk grid whose bricks can reach into the rectangle grown by margin chunks.
+     *
      * Returns:
-     * auto: const iterator to the end of the vector of bricks.
+     * bool: false if no cell can, the range is not set then.
+     */
+    bool cell_range(const SDL_Rect& rect, int margin, int& first_col, int& first_row, int& last_col, int& last_row) const;
+
+    /**
+     * Decode the bricks of a cold chunk, with their visibility, into spare buffers when there are any.
+     */
+    void decode(uint32_t chunk);
+
+    /**
+     * Drop the decoded bricks of a hot chunk, keeping the buffers as spares.
+     */
+    void evict(uint32_t chunk);
+
+    /**
+     * Pack bricks into a chunk.
+     *
+     * Params:
+     * std::pmr::vector<uint8_t>& packed: the bricks are appended to it.
+     * std::span<const Brick> bricks: all the bricks of the level.
+     * std::span<const uint32_t> indices: indices of the chunk's bricks, increasing.
+     * int origin_x, origin_y: top left corner of the chunk.
+     */
+    static void pack(std::pmr::vector<uint8_t>& packed, std::span<const Brick> bricks, std::span<const uint32_t> indices, int origin_x, int origin_y);
+
+    /**
+     * Unpack the bricks of a chunk packed by pack(), all visible.
      */
-    std::vector<Brick>::const_iterator cend() const;
+    static void unpack(const Chunk& chunk, std::pmr::vector<Brick>& bricks, std::pmr::vector<uint32_t>& indices);
 };
 
-#endif // !BRICKS_H
\ No newline at end of file
+#endif // !BRICKS_H
@@ -1,18 +1,20 @@
 #ifndef BRICKSLAYOUT_H
 #define BRICKSLAYOUT_H
 
+#include <memory_resource>
 #include <vector>
 #include "Brick.h"
 
 /**
  * Interface for creating bricks layouts. 
- * Each created layout must implement a create_bricks method that returns a vector of bricks.
+ * Each created layout must implement a create_bricks method that returns a vector of bricks, allocated from the
+ * memory resource it is given. Bricks passes the scratch arena of its construction, the vector goes with the arena.
  * Layouts can be created by implementing this interface and passing it to the ArkanoidGame class through polymorphism.
  */
 
 class BricksLayout {
 public:
-    virtual std::vector<Brick> create_bricks() = 0;
+    virtual std::pmr::vector<Brick> create_bricks(std::pmr::memory_resource* arena) = 0;
     virtual ~BricksLayout() = default;
 };
 
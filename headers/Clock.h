@@ -0,0 +1,87 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <cstdint>
+
+/**
+ * Source of time for everything that paces or schedules the game.
+ *
+ * Times are nanoseconds since an arbitrary epoch, never 0. The frame limiter and the scheduler only ever see time
+ * through a Clock, so the whole game can run on a VirtualClock that is advanced by hand: waiting becomes a jump of
+ * the clock, and an hour of play simulates in the time the CPU needs for its frames.
+ *
+ * Public Methods:
+ *  - uint64_t now(): current time.
+ *  - void sleep(): give up the CPU for a number of milliseconds, may oversleep.
+ *  - void spin_until(): wait precisely until a time.
+ *
+ */
+class Clock
+{
+public:
+    virtual ~Clock() = default;
+
+    /**
+     * Get the current time in nanoseconds.
+     */
+    virtual uint64_t now() const = 0;
+
+    /**
+     * Give up the CPU for at least the given time. A real clock may oversleep by the OS scheduler granularity.
+     *
+     * Params:
+     * uint32_t ms: time to sleep in milliseconds.
+     */
+    virtual void sleep(uint32_t ms) = 0;
+
+    /**
+     * Wait until the given time without giving up the CPU, returns right away if it already passed.
+     *
+     * Params:
+     * uint64_t deadline: time to wait for in nanoseconds.
+     */
+    virtual void spin_until(uint64_t deadline) = 0;
+};
+
+/**
+ * Wall clock on the SDL performance counter. Sleeps with SDL_Delay, spins with a CPU pause between the reads.
+ */
+class RealClock : public Clock
+{
+public:
+    uint64_t now() const override;
+    void sleep(uint32_t ms) override;
+    void spin_until(uint64_t deadline) override;
+
+    /**
+     * Get the current time of the SDL performance counter in nanoseconds.
+     */
+    static uint64_t performance_now();
+};
+
+/**
+ * Clock that only moves when waited on. Sleeping and spinning advance it instantly by exactly the requested time, so
+ * nothing ever waits and there is no oversleep. Used by the thread driving it only.
+ *
+ * uint64_t m_now: current time in nanoseconds.
+ *
+ */
+class VirtualClock : public Clock
+{
+    uint64_t m_now;
+
+public:
+    /**
+     * Constructor for the VirtualClock class.
+     *
+     * Params:
+     * uint64_t start: initial time in nanoseconds, MUST NOT be 0.
+     */
+    VirtualClock(uint64_t start = 1'000'000'000);
+
+    uint64_t now() const override;
+    void sleep(uint32_t ms) override;
+    void spin_until(uint64_t deadline) override;
+};
+
+#endif // !CLOCK_H
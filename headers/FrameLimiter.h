@@ -1,44 +1,122 @@
 #ifndef FRAME_LIMITER_H
 #define FRAME_LIMITER_H
 
-#include "SDL.h"
+#include <cstdint>
+
+#include "Clock.h"
+
+/**
+ * How the frame limiter places the work of a frame inside the frame period.
+ *
+ * Steady: the frame starts right at its deadline, then the game waits for the next one. The input is sampled a
+ *      whole period before the frame is due on screen.
+ * LowLatency: the wait comes first and ends the predicted duration of the frame before its deadline, so the input
+ *      is sampled, simulated, rendered and presented just in time for it.
+ */
+enum class FramePacing
+{
+    Steady,
+    LowLatency
+};
 
 /**
  * FrameLimiter
- * 
- * This class is used to limit the frame rate of the game. 
- * Implemented roughly using SDL_Delay function which calls os sleep with poor resolution.
- * 
+ *
+ * This class is used to limit the frame rate of the game.
+ * Works with nanosecond deadlines on the given Clock. The deadline of frame n is origin + n * 1e9 / fps
+ * computed exactly, so the error of a late or early frame is carried over to the next one and the long run rate
+ * is exact even when the period is not a whole number of milliseconds (60 fps = 16.67 ms).
+ * The wait first sleeps (Clock::sleep()) until the deadline is closer than the expected oversleep of the OS, then
+ * spins (Clock::spin_until()) for the rest. The oversleep is measured on every sleep and the spin margin
+ * adapts to it, keeping the jitter well under a millisecond without spinning for the whole frame.
+ * With FramePacing::LowLatency the wait ends early by the predicted work of a frame: the longest of the last
+ * work_history frames (start_frame() to end_work()) plus a safety margin.
+ *
+ * Clock& m_clock: time the frames are paced on.
+ * int m_desired_fps: desired frames per second.
+ * uint64_t m_origin: time the current run of deadlines started at, in nanoseconds.
+ * uint64_t m_frame_index: index of the current frame since m_origin.
+ * uint64_t m_start: start of the current frame in nanoseconds.
+ * uint64_t m_spin_margin: how long before the deadline to stop sleeping and start spinning, in nanoseconds.
+ * FramePacing m_pacing: where the wait is placed in the frame.
+ * uint64_t m_present_deadline: time the current frame is due on screen, in nanoseconds.
+ * uint64_t m_work[]: durations of the last frames' work, in nanoseconds, a ring indexed by m_work_index.
+ *
  * Public Methods:
  *  - void start_frame(): start the frame.
  *  - void limit_to_desired(): limit the frame rate to the desired frame rate.
- * 
+ *  - void end_work(): mark the end of the work of the frame, after it was presented.
+ *  - uint64_t get_frame_start(): start of the current frame in nanoseconds.
+ *  - uint64_t get_present_deadline(): time the current frame is due on screen in nanoseconds.
+ *  - uint64_t predicted_work(): predicted duration of the work of a frame in nanoseconds.
+ *
  */
 class FrameLimiter
 {
+public:
+    static constexpr int work_history = 32;
+
+private:
+    Clock& m_clock;
     int m_desired_fps;
-    int m_delta;
-    uint64_t m_start;
+    uint64_t m_origin = 0;
+    uint64_t m_frame_index = 0;
+    uint64_t m_start = 0;
+    uint64_t m_spin_margin;
+    FramePacing m_pacing;
+    uint64_t m_present_deadline = 0;
+    uint64_t m_work[work_history] = {};
+    int m_work_index = 0;
 
 public:
     /**
-     * Constructor for the FrameLimiter class. 
-     * 
+     * Constructor for the FrameLimiter class.
+     *
      * Params:
+     * Clock& clock: time to pace the frames on, MUST outlive the limiter.
      * int desired_fps: desired frames per second.
+     * FramePacing pacing: where the wait is placed in the frame.
      */
-    FrameLimiter(int desired_fps = 60);
-    
+    FrameLimiter(Clock& clock, int desired_fps = 60, FramePacing pacing = FramePacing::Steady);
+
     /**
      * Start the frame and record the start time.
      */
     void start_frame();
 
     /**
-     * Roughly limit the frame rate to the desired frame rate.
+     * Mark the end of the work of the current frame, feeds the prediction of the low latency pacing.
+     */
+    void end_work();
+
+    /**
+     * Wait for the next frame. Steady pacing waits until the deadline of the next frame, low latency pacing until
+     * the predicted work before it. If the game fell behind by more than a frame the deadlines are restarted from
+     * now instead of rushing the missed frames.
      */
     void limit_to_desired();
 
+    /**
+     * Get the start of the current frame in nanoseconds of the clock.
+     */
+    uint64_t get_frame_start() const;
+
+    /**
+     * Get the time the current frame is due on screen in nanoseconds of the clock: the deadline
+     * the frame is paced to. A frame finished earlier waits for it, so that is when its input reaches the player.
+     */
+    uint64_t get_present_deadline() const;
+
+    /**
+     * Get the predicted duration of the work of a frame in nanoseconds, at most one frame period.
+     */
+    uint64_t predicted_work() const;
+
+private:
+    /**
+     * Deadline of the frame with the given index since the origin, in nanoseconds.
+     */
+    uint64_t deadline(uint64_t frame_index) const;
 };
 
-#endif // !FRAME_LIMITER_H
\ No newline at end of file
+#endif // !FRAME_LIMITER_H
@@ -0,0 +1,218 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <cstdint>
+#include <cstdio>
+#include <atomic>
+#include <memory>
+#include <string_view>
+
+/**
+ * Timed phases of a frame.
+ *
+ * Frame: start to start interval of consecutive frames, what the player experiences.
+ * Poll: draining the SDL event queue.
+ * Input: reading (and recording) the input of the tick.
+ * Sim: the game simulation.
+ * Render: recording and submitting the draw commands of the playfield.
+ * Hud: preparing and recording the score.
+ * Present: presenting (and capturing) the finished frame.
+ * Latency: from sampling the input until the frame is due on screen (FrameLimiter::get_present_deadline()).
+ */
+enum class FrameChannel : int
+{
+    Frame = 0,
+    Poll,
+    Input,
+    Sim,
+    Render,
+    Hud,
+    Present,
+    Latency,
+    Count
+};
+
+/**
+ * Lock-free log-linear histogram of durations in nanoseconds.
+ *
+ * Values below 64 ns get a bucket each, above that every power of two is split into 32 buckets, so any recorded
+ * value is off by at most ~3% in the percentiles. Durations up to ~18 minutes are kept, longer ones are clamped.
+ * The histogram has a single writer thread: recording is a handful of relaxed atomic loads and stores without any
+ * locked instruction, while any other thread can read consistent-enough percentiles at the same time.
+ *
+ * Public Methods:
+ *  - void record(): add a duration.
+ *  - uint64_t percentile(): duration below which the given fraction of the recorded values lies.
+ *  - uint64_t count(), max(), mean(): number of values, largest and average value.
+ *  - void reset(): forget all values.
+ *
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr int sub_bucket_bits = 5;
+    static constexpr int linear_limit = 2 << sub_bucket_bits;      // values below this have a bucket each
+    static constexpr int max_exponent = 40;                          // 2^40 ns ~ 18 minutes
+    static constexpr int bucket_count = linear_limit + (max_exponent - sub_bucket_bits) * (1 << sub_bucket_bits);
+
+private:
+    std::atomic<uint64_t> m_buckets[bucket_count] = {};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_sum{0};
+    std::atomic<uint64_t> m_max{0};
+
+public:
+    /**
+     * Add a duration.
+     *
+     * Params:
+     * uint64_t ns: duration in nanoseconds.
+     */
+    void record(uint64_t ns);
+
+    /**
+     * Get the duration below which the given fraction of the recorded values lies.
+     *
+     * Params:
+     * double fraction: 0.5 for the median, 0.99 for the 99th percentile.
+     *
+     * Returns:
+     * uint64_t: the percentile in nanoseconds, 0 if nothing was recorded.
+     */
+    uint64_t percentile(double fraction) const;
+
+    /**
+     * Get the number of recorded values.
+     */
+    uint64_t count() const;
+
+    /**
+     * Get the largest recorded value in nanoseconds.
+     */
+    uint64_t max() const;
+
+    /**
+     * Get the average of the recorded values in nanoseconds.
+     */
+    uint64_t mean() const;
+
+    /**
+     * Forget all values.
+     */
+    void reset();
+
+private:
+    /**
+     * Bucket a value falls into.
+     */
+    static int bucket_of(uint64_t ns);
+
+    /**
+     * Representative value (middle) of a bucket.
+     */
+    static uint64_t value_of(int bucket);
+};
+
+/**
+ * Frame time statistics of a run.
+ *
+ * Recorded from the game thread only (see LatencyHistogram), readable from anywhere.
+ * Keeps a histogram per FrameChannel for the whole run and another one for the current second. Frames longer than
+ * the frame budget (1 / fps, with 5% tolerance) are counted as missed. A summary with p50/p95/p99/max of every
+ * channel is logged when the object is destroyed. Optionally a CSV row with the statistics of every second is
+ * streamed into a file.
+ *
+ * LatencyHistogram m_total[]: histograms of the whole run, per channel.
+ * LatencyHistogram m_window[]: histograms of the current second, per channel.
+ * uint64_t m_budget: frame budget in nanoseconds, including the tolerance.
+ * std::atomic<uint64_t> m_missed, m_window_missed: frames over budget in the run and in the current second.
+ * uint64_t m_window_start: start of the current second, 0 before the first frame.
+ * uint64_t m_window_index: number of finished seconds.
+ * std::unique_ptr<std::FILE, decltype(&std::fclose)> m_csv: per second CSV output, null if not requested.
+ *
+ * Public Methods:
+ *  - void record(): add a duration to a channel.
+ *  - void end_frame(): finish the frame, emits the CSV row when a second elapsed.
+ *  - const LatencyHistogram& get(): histogram of the whole run for a channel.
+ *  - uint64_t get_missed(): number of frames over budget.
+ *  - void log_summary(): log the statistics of the whole run.
+ *  - void write_json(): write the statistics of the whole run as a JSON object.
+ *
+ */
+class FrameStats
+{
+    LatencyHistogram m_total[static_cast<int>(FrameChannel::Count)];
+    LatencyHistogram m_window[static_cast<int>(FrameChannel::Count)];
+    uint64_t m_budget;
+    std::atomic<uint64_t> m_missed{0};
+    std::atomic<uint64_t> m_window_missed{0};
+    uint64_t m_window_start = 0;
+    uint64_t m_window_index = 0;
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> m_csv{nullptr, std::fclose};
+
+public:
+    FrameStats(const FrameStats&) = delete;
+    FrameStats& operator=(const FrameStats&) = delete;
+
+    /**
+     * Constructor for the FrameStats class.
+     *
+     * Params:
+     * int fps: target frames per second, defines the frame budget.
+     * const std::string_view csv_path: file to stream the per second CSV into, empty for none. MUST be zero terminated.
+     */
+    FrameStats(int fps, const std::string_view csv_path = {});
+
+    /**
+     * Logs the summary of the run.
+     */
+    ~FrameStats();
+
+    /**
+     * Add a duration to a channel. Frame durations over the budget are counted as missed.
+     *
+     * Params:
+     * FrameChannel channel: phase the duration belongs to.
+     * uint64_t ns: duration in nanoseconds.
+     */
+    void record(FrameChannel channel, uint64_t ns);
+
+    /**
+     * Finish the frame. Writes the CSV row of the last second once a second has elapsed.
+     *
+     * Params:
+     * uint64_t now: current time in nanoseconds.
+     */
+    void end_frame(uint64_t now);
+
+    /**
+     * Get the histogram of the whole run for a channel.
+     */
+    const LatencyHistogram& get(FrameChannel channel) const;
+
+    /**
+     * Get the number of frames over budget.
+     */
+    uint64_t get_missed() const;
+
+    /**
+     * Log p50/p95/p99/max of every channel and the number of missed frames.
+     */
+    void log_summary() const;
+
+    /**
+     * Write the statistics of the whole run as a JSON object, one member per channel with its count, mean,
+     * p50/p95/p99 and max in milliseconds.
+     *
+     * Params:
+     * std::FILE* file: file to write into.
+     */
+    void write_json(std::FILE* file) const;
+
+    /**
+     * Name of a channel, used in the summary and the CSV header.
+     */
+    static const char* channel_name(FrameChannel channel);
+};
+
+#endif // !FRAME_STATS_H
@@ -7,8 +7,8 @@
  * 
  * Settings for the game.
  * 
- * int screen_width: width of the game screen resolution.
- * int screen_height: height of the game screen resolution.
+ * int screen_width: width of the playfield. The window is at most this wide, a larger playfield scrolls.
+ * int screen_height: height of the playfield.
  * 
  * int paddle_width: width of the paddle.
  * int paddle_height: height of the paddle.
@@ -19,7 +19,11 @@
  * int ball_speed: speed (velocity) of the ball in both directions.
  * int num_of_balls: number of balls the player has before the game ends.
  * 
- * int fps_limit: frames per second limit.
+ * int fps_limit: frames per second limit. The speeds above are in pixels per frame at this rate.
+ * 
+ * int physics_hz: rate of the fixed physics step, input is read once per step.
+ * int hud_hz: rate the score text is refreshed at.
+ * int telemetry_hz: rate the telemetry (render statistics) is logged at.
  */
 struct GameSettings
 {
@@ -37,6 +41,10 @@ struct GameSettings
 
     const int fps_limit;
 
+    const int physics_hz;
+    const int hud_hz;
+    const int telemetry_hz;
+
     GameSettings(
         const int screen_width,
         const int screen_height,
@@ -47,7 +55,10 @@ struct GameSettings
         const int ball_size,
         const int ball_speed,
         const int num_of_balls,
-        const int fps_limit
+        const int fps_limit,
+        const int physics_hz = 240,
+        const int hud_hz = 10,
+        const int telemetry_hz = 1
     ) :
         screen_width{ screen_width },
         screen_height{ screen_height },
@@ -58,7 +69,10 @@ struct GameSettings
         ball_size{ ball_size },
         ball_speed{ ball_speed },
         num_of_balls{ num_of_balls },
-        fps_limit{ fps_limit }
+        fps_limit{ fps_limit },
+        physics_hz{ physics_hz },
+        hud_hz{ hud_hz },
+        telemetry_hz{ telemetry_hz }
     {
     }
 };
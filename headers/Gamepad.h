@@ -0,0 +1,140 @@
+#ifndef GAMEPAD_H
+#define GAMEPAD_H
+
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "SDL.h"
+
+#include "InputLog.h"
+#include "SpscQueue.h"
+
+/**
+ * State of the gamepad at an instant, as sampled by the Gamepad thread.
+ */
+struct GamepadSample
+{
+    uint64_t time;          // nanoseconds of the RealClock
+    int axis;               // horizontal deflection after the deadzone, -32767 (left) to 32767 (right)
+    InputBits buttons;      // InputAction bits of the pressed buttons and D-pad
+};
+
+/**
+ * SDL game controller read on a background thread at a high rate.
+ *
+ * The thread samples the first attached controller every 1 / sample_hz seconds, independently of the frame rate,
+ * and hands the samples to the simulation through a lock-free SpscQueue. Every physics step consumes the samples
+ * taken up to its time: the analog stick is averaged over them, so its motion between two frames is not lost, and
+ * the buttons pressed in any of them are latched for the step. The left stick and the D-pad move the paddle, A
+ * launches, Start restarts and Back quits. Stick deflections inside the deadzone read as centered, the rest of the
+ * range is rescaled to start at 0. A controller plugged in later is picked up by the thread.
+ * While the game idles nothing consumes the samples: pause() keeps the thread reading the controller (its SDL events
+ * wake the game) without queueing, and resume() drops the samples queued before the wait, so the first step after it
+ * does not average stale ones and m_dropped only counts real overruns.
+ *
+ * std::unique_ptr<SDL_GameController, decltype(&SDL_GameControllerClose)> m_controller: the controller, owned by
+ *      the thread, null while none is attached.
+ * int m_deadzone: stick deflection read as centered.
+ * uint64_t m_period: time between samples in nanoseconds.
+ * SpscQueue<GamepadSample, queue_capacity> m_samples: samples waiting for the simulation.
+ * std::atomic<uint64_t> m_dropped: samples dropped because the simulation did not keep up.
+ * GamepadSample m_last: last consumed sample, repeated while no new ones arrive.
+ * std::atomic<bool> m_paused: the thread reads the controller without queueing the samples.
+ *
+ * Public Methods:
+ *  - InputBits consume(): actions of a physics step at the given time.
+ *  - void pause(): stop queueing samples while the game idles.
+ *  - void resume(): queue samples again, dropping the stale ones.
+ *  - uint64_t get_dropped(): number of samples dropped on a full queue.
+ *
+ */
+class Gamepad
+{
+public:
+    static constexpr size_t queue_capacity = 256;
+
+private:
+    std::unique_ptr<SDL_GameController, decltype(&SDL_GameControllerClose)> m_controller{nullptr, SDL_GameControllerClose};
+    int m_deadzone;
+    uint64_t m_period;
+    SpscQueue<GamepadSample, queue_capacity> m_samples;
+    std::atomic<uint64_t> m_dropped{0};
+    GamepadSample m_last{0, 0, 0};
+    std::atomic<bool> m_paused{false};
+    std::atomic<bool> m_stop{false};
+    std::thread m_thread;
+
+public:
+    Gamepad(const Gamepad&) = delete;
+    Gamepad& operator=(const Gamepad&) = delete;
+
+    /**
+     * Constructor for the Gamepad class. Initializes the SDL game controller subsystem and starts sampling.
+     *
+     * Params:
+     * int sample_hz: samples per second.
+     * int deadzone: stick deflection read as centered, 0 to 32767.
+     *
+     * Throws:
+     * std::runtime_error: if the game controller subsystem could not be initialized.
+     */
+    Gamepad(int sample_hz = 1000, int deadzone = 8000);
+
+    /**
+     * Stops the thread, closes the controller and the subsystem.
+     */
+    ~Gamepad();
+
+    /**
+     * Consume the samples taken up to the given time and get the actions of the step at that time. The stick is
+     * mapped onto InputAction::Left or Right with its averaged deflection in InputAction::Speed, a fully deflected
+     * stick or the D-pad move at full speed.
+     *
+     * Params:
+     * uint64_t time: time of the step in nanoseconds of the RealClock.
+     *
+     * Returns:
+     * InputBits: actions of the step, see InputAction.
+     */
+    InputBits consume(uint64_t time);
+
+    /**
+     * Stop queueing samples, for a wait in which no physics step consumes them. The controller is still read.
+     */
+    void pause();
+
+    /**
+     * Queue samples again after pause(). The samples queued before the given time are dropped, the last of them is
+     * kept as the state of the controller until new ones arrive.
+     *
+     * Params:
+     * uint64_t time: end of the wait in nanoseconds of the RealClock.
+     */
+    void resume(uint64_t time);
+
+    /**
+     * Get the number of samples dropped because the queue was full.
+     */
+    uint64_t get_dropped() const;
+
+private:
+    /**
+     * Body of the sampling thread.
+     */
+    void sampler_main();
+
+    /**
+     * Read the controller, opening the first attached one if there is none.
+     *
+     * Params:
+     * GamepadSample& sample: filled with the state of the controller.
+     *
+     * Returns:
+     * bool: false if no controller is attached.
+     */
+    bool sample(GamepadSample& sample);
+};
+
+#endif // !GAMEPAD_H
@@ -0,0 +1,281 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <string_view>
+
+#include "Brick.h"
+#include "GameSettings.h"
+
+/**
+ * Player actions of a single simulation tick as a bit set. Everything the game reads from the keyboard and the
+ * gamepad goes through these bits, so a session can be recorded and replayed exactly. The top three bits hold the
+ * speed of an analog paddle move in eighths of the full speed, 0 (the keyboard) being the full speed.
+ */
+using InputBits = uint8_t;
+
+namespace InputAction
+{
+    constexpr InputBits Left = 1 << 0;      // move the paddle left
+    constexpr InputBits Right = 1 << 1;     // move the paddle right
+    constexpr InputBits Launch = 1 << 2;    // launch the ball
+    constexpr InputBits Quit = 1 << 3;      // quit (Q or ESC)
+    constexpr InputBits Restart = 1 << 4;   // restart from the end screen (R)
+    constexpr int speed_shift = 5;
+    constexpr InputBits Speed = 7 << speed_shift;   // analog paddle speed in eighths, 0 for full speed
+}
+
+/**
+ * Records the input bits of every tick of a session into a compact log, written as the session goes, together
+ * with periodic keyframes of the game state for seeking in the replay.
+ *
+ * File format (little endian):
+ *  - char[4] magic "ARKI"
+ *  - uint32_t version, 4
+ *  - uint64_t seed of the game's random generator
+ *  - int32_t[13] GameSettings, in declaration order
+ *  - uint32_t number of bricks, then per brick int32_t x, y, width, height, points and uint8_t r, g, b, a
+ *  - records until the end of the file, each starting with a varint (LEB128):
+ *      - n > 0: a run, uint8_t input bits held for the next n ticks
+ *      - 0: a keyframe, the game state before the next tick. varint size of the state, varint size of the delta,
+ *        then the delta against the previous keyframe's state (zeros for the first): pairs of varint count of
+ *        unchanged bytes skipped and varint count of changed bytes, followed by the changed bytes copied verbatim
+ *        from the new state. Unchanged bytes at the end are not encoded.
+ *
+ * A tick is a physics step of the game loop or a frame of the end screen. The input rarely changes between ticks,
+ * so a run costs 2-4 bytes per change of the input and an hour of play takes a few kilobytes. Between keyframes
+ * only the moving objects, the score and the odd hit brick change, so the delta of a keyframe is a few dozen bytes
+ * whatever the number of bricks. Encoded records are collected in memory and appended to the file by a background
+ * thread once a second (or when 4 KB piled up), the game never waits for the disk. The header is written by the
+ * constructor, the last run by the destructor.
+ *
+ * InputBits m_current: input of the run being counted.
+ * uint64_t m_run: ticks of the run being counted, 0 before the first tick.
+ * uint64_t m_ticks: ticks recorded.
+ * uint64_t m_keyframe_interval: ticks between keyframes.
+ * uint64_t m_next_keyframe: tick the next keyframe is due at.
+ * std::vector<uint8_t> m_keyframe: state of the last keyframe, the base of the next delta.
+ * std::vector<uint8_t> m_delta: scratch buffer for the delta of a keyframe, sized once for the largest delta.
+ * std::vector<uint8_t> m_pending: encoded records waiting for the writer thread.
+ * size_t m_pending_capacity: capacity kept by m_pending and the buffer of the writer thread.
+ *
+ * Public Methods:
+ *  - void record(): append the input of the next tick.
+ *  - bool keyframe_due(): a keyframe should be added before the next tick.
+ *  - void keyframe(): append a keyframe of the game state before the next tick.
+ *  - uint64_t get_tick_count(): number of recorded ticks.
+ *
+ */
+class InputRecorder
+{
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> m_file;
+    InputBits m_current = 0;
+    uint64_t m_run = 0;
+    uint64_t m_ticks = 0;
+    uint64_t m_keyframe_interval;
+    uint64_t m_next_keyframe = 0;
+    std::vector<uint8_t> m_keyframe;
+    std::vector<uint8_t> m_delta;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<uint8_t> m_pending;
+    size_t m_pending_capacity = 0;
+    bool m_stop = false;
+    std::thread m_writer_thread;
+
+public:
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    /**
+     * Constructor for the InputRecorder class. Writes the header and starts the writer thread.
+     *
+     * Params:
+     * const std::string_view path: path of the log file. MUST be zero terminated.
+     * uint64_t seed: seed of the game's random generator.
+     * const GameSettings& settings: settings of the recorded game.
+     * const std::vector<Brick>& bricks: bricks of the recorded game, as laid out.
+     * uint64_t keyframe_interval: ticks between keyframes, at least 1.
+     *
+     * Throws:
+     * std::runtime_error: if the file could not be opened or written.
+     */
+    InputRecorder(
+        const std::string_view path,
+        uint64_t seed,
+        const GameSettings& settings,
+        const std::vector<Brick>& bricks,
+        uint64_t keyframe_interval
+    );
+
+    /**
+     * Writes the last run and stops the writer thread.
+     */
+    ~InputRecorder();
+
+    /**
+     * Append the input of the next tick.
+     */
+    void record(InputBits input);
+
+    /**
+     * Check whether a keyframe is due: the keyframe interval passed since the last one, or there was none yet.
+     */
+    bool keyframe_due() const;
+
+    /**
+     * Append a keyframe of the game state before the next tick, delta encoded against the previous one.
+     *
+     * Params:
+     * const std::vector<uint8_t>& state: the game state, opaque to the log. Always of the same size in a session.
+     */
+    void keyframe(const std::vector<uint8_t>& state);
+
+    /**
+     * Get the number of recorded ticks.
+     */
+    uint64_t get_tick_count() const;
+
+private:
+    /**
+     * Encode the run being counted and queue it for the writer thread.
+     */
+    void emit_run();
+
+    /**
+     * Body of the writer thread.
+     */
+    void writer_main();
+};
+
+/**
+ * Plays back a log written by InputRecorder and holds what is needed to rebuild its game: the seed, the
+ * GameSettings and the bricks. The keyframes are decoded into full states on load, so seeking is a binary search
+ * for the nearest keyframe plus a binary search for the run of the wanted tick.
+ *
+ * uint64_t m_seed: seed of the game's random generator.
+ * int32_t m_settings[]: GameSettings values, in declaration order.
+ * std::vector<Brick> m_bricks: bricks of the recorded game.
+ * std::vector<Run> m_runs: decoded runs of the input, with the tick each of them starts at.
+ * std::vector<Keyframe> m_keyframes: decoded keyframes, ordered by their tick.
+ * size_t m_run_index, uint64_t m_run_position: next tick to play.
+ * uint64_t m_tick_count: number of ticks in the log.
+ *
+ * Public Methods:
+ *  - bool next(): get the input of the next tick.
+ *  - const Keyframe* find_keyframe(): the last keyframe at or before a tick.
+ *  - void seek(): continue playing from a tick.
+ *  - uint64_t get_position(): the next tick to play.
+ *  - size_t get_tick_count(): number of ticks in the log.
+ *  - uint64_t get_seed(), GameSettings get_settings(), const std::vector<Brick>& get_bricks(): the recorded game.
+ *
+ */
+class InputPlayback
+{
+public:
+    /**
+     * Game state before a tick.
+     */
+    struct Keyframe
+    {
+        uint64_t tick;
+        std::vector<uint8_t> state;
+    };
+
+private:
+    /**
+     * Input held for a number of ticks.
+     */
+    struct Run
+    {
+        uint64_t start;
+        uint64_t ticks;
+        InputBits input;
+    };
+
+    uint64_t m_seed = 0;
+    int32_t m_settings[13] = {};
+    std::vector<Brick> m_bricks;
+    std::vector<Run> m_runs;
+    std::vector<Keyframe> m_keyframes;
+    size_t m_run_index = 0;
+    uint64_t m_run_position = 0;
+    uint64_t m_tick_count = 0;
+
+public:
+    /**
+     * Constructor for the InputPlayback class. Loads the whole log.
+     *
+     * Params:
+     * const std::string_view path: path of the log file. MUST be zero terminated.
+     *
+     * Throws:
+     * std::runtime_error: if the file could not be read or is not an input log.
+     */
+    InputPlayback(const std::string_view path);
+
+    /**
+     * Get the input of the next tick.
+     *
+     * Params:
+     * InputBits& input: set to the input of the tick.
+     *
+     * Returns:
+     * bool: false when the log is exhausted.
+     */
+    bool next(InputBits& input);
+
+    /**
+     * Find the keyframe to restore to get to a tick.
+     *
+     * Params:
+     * uint64_t tick: the wanted tick.
+     *
+     * Returns:
+     * const Keyframe*: the last keyframe at or before the tick, null if there is none.
+     */
+    const Keyframe* find_keyframe(uint64_t tick) const;
+
+    /**
+     * Continue playing from a tick, the next call to next() returns its input.
+     *
+     * Params:
+     * uint64_t tick: the tick, clamped to the end of the log.
+     */
+    void seek(uint64_t tick);
+
+    /**
+     * Get the next tick to play.
+     */
+    uint64_t get_position() const;
+
+    /**
+     * Get the number of ticks in the log.
+     */
+    size_t get_tick_count() const;
+
+    /**
+     * Get the seed of the recorded game's random generator.
+     */
+    uint64_t get_seed() const;
+
+    /**
+     * Get the settings of the recorded game.
+     */
+    GameSettings get_settings() const;
+
+    /**
+     * Get the bricks of the recorded game, as laid out at its start.
+     */
+    const std::vector<Brick>& get_bricks() const;
+};
+
+#endif // !INPUT_LOG_H
@@ -0,0 +1,84 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include <cstdint>
+
+#include "InputLog.h"
+
+/**
+ * A key press or release of a game action, with the time it happened.
+ */
+struct KeyEvent
+{
+    uint64_t time;          // nanoseconds of the game clock
+    InputBits action;       // InputAction bit of the key
+    bool pressed;           // true for a press, false for a release
+};
+
+/**
+ * Bounded queue of timestamped key events between the event polling and the fixed rate simulation.
+ *
+ * The events are stored in a fixed ring, pushing and consuming never allocates. Every physics step consumes the
+ * events that happened up to its own time, so a key pressed in the middle of a frame takes effect on the step it
+ * was pressed at and not at the start of the next frame. A press is latched until the next consume(): a tap
+ * shorter than a step still acts for one step instead of being lost. When the ring is full the oldest event is
+ * applied right away to make room, the held keys stay correct.
+ *
+ * KeyEvent m_events[]: ring of pending events, m_size of them starting at m_head.
+ * InputBits m_held: actions whose key is down after the consumed events.
+ * InputBits m_latched: actions pressed since the last consume().
+ *
+ * Public Methods:
+ *  - void push(): queue a key event.
+ *  - InputBits consume(): actions of a step at the given time.
+ *  - int size(): number of pending events.
+ *
+ */
+class InputQueue
+{
+public:
+    static constexpr int capacity = 64;
+
+private:
+    KeyEvent m_events[capacity] = {};
+    int m_head = 0;
+    int m_size = 0;
+    InputBits m_held = 0;
+    InputBits m_latched = 0;
+
+public:
+    /**
+     * Queue a key event. Events are expected in time order, an earlier time is treated as the time of the last event.
+     *
+     * Params:
+     * uint64_t time: time of the event in nanoseconds of the game clock.
+     * InputBits action: InputAction bit of the key.
+     * bool pressed: true for a press, false for a release.
+     */
+    void push(uint64_t time, InputBits action, bool pressed);
+
+    /**
+     * Apply the events up to the given time and get the actions of the step at that time: the held keys and the
+     * keys pressed since the last step.
+     *
+     * Params:
+     * uint64_t time: time of the step in nanoseconds of the game clock.
+     *
+     * Returns:
+     * InputBits: actions of the step, see InputAction.
+     */
+    InputBits consume(uint64_t time);
+
+    /**
+     * Get the number of pending events.
+     */
+    int size() const;
+
+private:
+    /**
+     * Apply the oldest pending event to the held keys and remove it.
+     */
+    void apply_front();
+};
+
+#endif // !INPUT_QUEUE_H
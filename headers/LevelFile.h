@@ -0,0 +1,92 @@
+#ifndef LEVEL_FILE_H
+#define LEVEL_FILE_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "SDL.h"
+
+/**
+ * Binary level file (little endian): a LevelFileHeader, palette_size colors as uint8_t r, g, b, a and brick_count
+ * LevelFileBrick records, nothing else. Loaded by BinaryLevelLayout, written by the levelc tool.
+ */
+
+/**
+ * Fixed size header at the start of a binary level file.
+ *
+ * char magic[4]: "ARKL".
+ * uint32_t version: level_version.
+ * uint32_t width, height: size of the playfield the level was made for, in pixels.
+ * uint32_t palette_size: number of colors following the header, at most 256.
+ * uint32_t brick_count: number of brick records following the palette.
+ */
+struct LevelFileHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t palette_size;
+    uint32_t brick_count;
+};
+
+/**
+ * Packed brick record of a binary level file.
+ *
+ * int32_t x, y: top left corner of the brick.
+ * uint16_t width, height: size of the brick.
+ * uint16_t points: points the player earns by hitting the brick.
+ * uint8_t color: index of the brick's color in the palette.
+ * uint8_t flags: reserved, 0.
+ */
+struct LevelFileBrick
+{
+    int32_t x;
+    int32_t y;
+    uint16_t width;
+    uint16_t height;
+    uint16_t points;
+    uint8_t color;
+    uint8_t flags;
+};
+
+static_assert(sizeof(LevelFileHeader) == 24, "LevelFileHeader must be packed");
+static_assert(sizeof(LevelFileBrick) == 16, "LevelFileBrick must be packed");
+
+constexpr char level_magic[4] = {'A', 'R', 'K', 'L'};
+constexpr uint32_t level_version = 1;
+constexpr uint32_t level_max_palette_size = 256;
+
+/**
+ * Check whether a file starts with the magic of a binary level.
+ *
+ * Params:
+ * const std::string_view path: path of the file. MUST be zero terminated.
+ *
+ * Returns:
+ * bool: true for a binary level, false for anything else or a file that could not be read.
+ */
+bool is_level_file(const std::string_view path);
+
+/**
+ * Write a binary level file.
+ *
+ * Params:
+ * const std::string_view path: path of the file. MUST be zero terminated.
+ * uint32_t width, height: size of the playfield the level was made for.
+ * const std::vector<SDL_Color>& palette: colors the bricks index, at most level_max_palette_size.
+ * const std::vector<LevelFileBrick>& bricks: the brick records.
+ *
+ * Throws:
+ * std::runtime_error: if the file could not be written.
+ */
+void write_level_file(
+    const std::string_view path,
+    uint32_t width,
+    uint32_t height,
+    const std::vector<SDL_Color>& palette,
+    const std::vector<LevelFileBrick>& bricks
+);
+
+#endif // !LEVEL_FILE_H
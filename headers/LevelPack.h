@@ -0,0 +1,143 @@
+#ifndef LEVEL_PACK_H
+#define LEVEL_PACK_H
+
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Bricks.h"
+#include "BricksLayout.h"
+
+/**
+ * A level file opened as a layout, with the size of the playfield it was made for.
+ */
+struct LoadedLevel
+{
+    std::unique_ptr<BricksLayout> layout;
+    int width;
+    int height;
+};
+
+/**
+ * Open a level file, a binary level (BinaryLevelLayout) when it starts with the level magic, a text one
+ * (TextLayout) otherwise.
+ *
+ * Params:
+ * const std::string_view path: path of the level. MUST be zero terminated.
+ *
+ * Returns:
+ * LoadedLevel: the layout of the level and its playfield size.
+ *
+ * Throws:
+ * std::runtime_error: if the file could not be read or is not a valid level.
+ */
+LoadedLevel load_level(const std::string_view path);
+
+/**
+ * The bricks of a level ready to play, with the size of the playfield it was made for.
+ */
+struct LevelBricks
+{
+    std::unique_ptr<Bricks> bricks;
+    int width;
+    int height;
+};
+
+/**
+ * Ordered list of levels played one after another, with the next level prepared in the background.
+ *
+ * The pack is a text file listing a level file per line, relative to the pack's directory, '#' starts a comment.
+ * While a level is played the next one is loaded, parsed and laid out into a complete Bricks by a background task
+ * (prefetch()), take() then only moves the finished Bricks out, the game swaps a pointer. A level that was not
+ * prefetched, or not finished in time, is loaded by take() itself. The bricks come with the playfield size of their
+ * level, a level of a pack may be larger or smaller than the one before.
+ *
+ * std::vector<std::string> m_paths: the level files, in order.
+ * size_t m_current: index of the level being played.
+ * size_t m_prefetched: index of the level m_prefetch loads, valid while m_prefetch is.
+ * std::future<LevelBricks> m_prefetch: the background load, invalid when none was started.
+ *
+ * Public Methods:
+ *  - const std::string& get_path(): path of a level.
+ *  - size_t size(): number of levels.
+ *  - size_t get_current(): index of the level being played.
+ *  - void prefetch(): start loading a level in the background.
+ *  - LevelBricks take(): the bricks and playfield size of a level, made the current one.
+ *
+ */
+class LevelPack
+{
+    std::vector<std::string> m_paths;
+    size_t m_current = 0;
+    size_t m_prefetched = 0;
+    std::future<LevelBricks> m_prefetch;
+
+public:
+    LevelPack(const LevelPack&) = delete;
+    LevelPack& operator=(const LevelPack&) = delete;
+
+    /**
+     * Constructor for the LevelPack class. Reads the list of levels, the levels themselves are loaded later.
+     *
+     * Params:
+     * const std::string_view path: path of the pack file. MUST be zero terminated.
+     *
+     * Throws:
+     * std::runtime_error: if the file could not be read or lists no levels.
+     */
+    LevelPack(const std::string_view path);
+
+    /**
+     * Waits for a running prefetch.
+     */
+    ~LevelPack();
+
+    /**
+     * Get the path of a level.
+     */
+    const std::string& get_path(size_t index) const;
+
+    /**
+     * Get the number of levels.
+     */
+    size_t size() const;
+
+    /**
+     * Get the index of the level being played.
+     */
+    size_t get_current() const;
+
+    /**
+     * Start loading a level in the background. Nothing happens if it is already being prefetched. A prefetch of
+     * another level is waited for first.
+     *
+     * Params:
+     * size_t index: index of the level.
+     */
+    void prefetch(size_t index);
+
+    /**
+     * Get the bricks of a level and make it the current level. Prefetched bricks are handed over as they are.
+     *
+     * Params:
+     * size_t index: index of the level.
+     *
+     * Returns:
+     * LevelBricks: bricks of the level, ready to play, and the size of its playfield.
+     *
+     * Throws:
+     * std::runtime_error: if the level could not be loaded.
+     */
+    LevelBricks take(size_t index);
+
+private:
+    /**
+     * Load a level into bricks, on whatever thread calls it.
+     */
+    static LevelBricks load_bricks(const std::string& path);
+};
+
+#endif // !LEVEL_PACK_H
@@ -0,0 +1,106 @@
+#ifndef LEVEL_WATCHER_H
+#define LEVEL_WATCHER_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "Bricks.h"
+#include "LevelPack.h"
+
+/**
+ * Watches the level being played and rebuilds it on a background thread whenever the file changes, for editing
+ * levels while the game runs.
+ *
+ * The thread blocks in inotify on the directory of the level, so saves that replace the file (as most editors do)
+ * are seen as well as writes in place. A change is given a few milliseconds for the rest of the save to land, then
+ * the level is loaded and built into a Bricks on the thread. The finished bricks wait in a mailbox and an SDL event
+ * of get_event_type() is pushed, the game takes them when it handles the event at the start of a frame. Nothing is
+ * polled by the game loop, and an idle window wakes up for the new level. A level that fails to load is logged and
+ * the game keeps the bricks it has. The bricks come with the playfield size of the level, a save may resize it.
+ * inotify exists on Linux only, elsewhere the watcher logs that it is not supported and never reports a change.
+ *
+ * std::mutex m_mutex: guards the watched file and the mailbox.
+ * std::string m_directory, m_name: the watched file, split as inotify watches its directory.
+ * LevelBricks m_ready: bricks and playfield size of the changed level waiting for the game, null bricks when none.
+ * uint32_t m_event_type: SDL event type pushed when new bricks are ready.
+ * int m_inotify: the inotify descriptor, -1 when not supported.
+ * int m_watch: inotify watch of the directory, -1 when none.
+ * int m_wake: eventfd waking the thread to stop.
+ * std::thread m_thread: the thread waiting for changes.
+ *
+ * Public Methods:
+ *  - void watch(): watch another level file.
+ *  - uint32_t get_event_type(): SDL event type of a rebuilt level.
+ *  - LevelBricks take(): the rebuilt bricks and their playfield size.
+ *
+ */
+class LevelWatcher
+{
+    std::mutex m_mutex;
+    std::string m_directory;
+    std::string m_name;
+    LevelBricks m_ready;
+    uint32_t m_event_type = 0;
+    int m_inotify = -1;
+    int m_watch = -1;
+    int m_wake = -1;
+    std::thread m_thread;
+
+public:
+    LevelWatcher(const LevelWatcher&) = delete;
+    LevelWatcher& operator=(const LevelWatcher&) = delete;
+
+    /**
+     * Constructor for the LevelWatcher class. Starts watching the level. SDL must be initialized.
+     *
+     * Params:
+     * const std::string_view path: path of the level.
+     *
+     * Throws:
+     * std::runtime_error: if the watch could not be set up.
+     */
+    LevelWatcher(const std::string_view path);
+
+    /**
+     * Stops the thread and the watch.
+     */
+    ~LevelWatcher();
+
+    /**
+     * Watch another level file instead, when the game moves on to another level.
+     *
+     * Params:
+     * const std::string_view path: path of the level.
+     */
+    void watch(const std::string_view path);
+
+    /**
+     * Get the SDL event type pushed when a changed level was rebuilt.
+     */
+    uint32_t get_event_type() const;
+
+    /**
+     * Take the bricks of the last rebuilt level.
+     *
+     * Returns:
+     * LevelBricks: the bricks and the size of their playfield, null bricks if no level was rebuilt since the last call.
+     */
+    LevelBricks take();
+
+private:
+    /**
+     * Body of the watching thread.
+     */
+    void watcher_main();
+
+    /**
+     * Load the watched level into bricks, put them into the mailbox and notify the game. Logs a level that failed.
+     */
+    void rebuild();
+};
+
+#endif // !LEVEL_WATCHER_H
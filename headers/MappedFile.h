@@ -0,0 +1,62 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * Read-only memory mapping of a whole file, RAII.
+ *
+ * The file is mapped with mmap (CreateFileMapping / MapViewOfFile on Windows) and its pages are loaded by the OS
+ * on first access, opening even a large file costs nothing until it is read. The mapping stays valid until the
+ * object is destroyed.
+ *
+ * const uint8_t* m_data: first byte of the mapping, null for an empty file.
+ * size_t m_size: size of the file in bytes.
+ *
+ * Public Methods:
+ *  - const uint8_t* data(): the mapped bytes.
+ *  - size_t size(): number of mapped bytes.
+ *
+ */
+class MappedFile
+{
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_mapping = nullptr;      // HANDLE of the file mapping object
+#endif
+
+public:
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Constructor for the MappedFile class. Maps the whole file.
+     *
+     * Params:
+     * const std::string_view path: path of the file. MUST be zero terminated.
+     *
+     * Throws:
+     * std::runtime_error: if the file could not be opened or mapped.
+     */
+    MappedFile(const std::string_view path);
+
+    /**
+     * Unmaps the file.
+     */
+    ~MappedFile();
+
+    /**
+     * Get the mapped bytes, null for an empty file.
+     */
+    const uint8_t* data() const;
+
+    /**
+     * Get the number of mapped bytes.
+     */
+    size_t size() const;
+};
+
+#endif // !MAPPED_FILE_H
@@ -9,9 +9,11 @@
  * Paddle class represents the paddle in the game. It can move left and right. A wrapper around SDL_Rect.
  * 
  * SDL_Rect m_rect: rectangle representing the paddle.
- * int m_paddle_speed: speed of the paddle.
+ * int m_paddle_speed: speed of the paddle, in pixels per 1 / m_speed_rate seconds.
+ * int m_speed_rate, m_tick_rate: the speed is scaled by m_speed_rate / m_tick_rate per move, the fraction of a pixel
+ *      left over is kept in m_step_remainder (in 1 / (m_tick_rate * full_speed) pixels) for the next move.
  * 
- * const SDL_Rect m_original_rect: original rectangle of the paddle when the instance was constructed.
+ * SDL_Rect m_original_rect: rectangle the paddle is reset to, where it was constructed or set_origin() put it.
  * 
  * Public Methods:
  * - SDL_Rect* get(): get the SDL_Rect of the paddle.
@@ -21,6 +23,8 @@
  * - void move_right(): move the paddle to the right.
  * 
  * - void reset(): reset the paddle to the original position.
+ * - void set_origin(): move the original position of the paddle and reset the paddle to it.
+ * - State get_state(), void set_state(): save and restore the mutable state of the paddle.
  * 
  * - int left(): get the left edge of the paddle.
  * - int right(): get the right edge of the paddle.
@@ -33,12 +37,28 @@
  */
 class Paddle
 {
+public:
+    static constexpr int full_speed = 8;
+
+private:
     SDL_Rect m_rect;
     int m_paddle_speed;
+    int m_speed_rate;
+    int m_tick_rate;
+    int m_step_remainder = 0;
 
-    const SDL_Rect m_original_rect;
+    SDL_Rect m_original_rect;
 
 public:
+    /**
+     * Everything about the paddle that changes while playing, for saving and restoring a game.
+     */
+    struct State
+    {
+        int x, y;
+        int step_remainder;
+    };
+
     /**
      * Constructor for the Paddle class.
      * 
@@ -47,10 +67,12 @@ public:
      * int y: y position of the left top corner of the paddle.
      * int paddle_width: width of the paddle.
      * int paddle_height: height of the paddle.
-     * int paddle_speed: speed of the paddle.
+     * int paddle_speed: speed of the paddle, in pixels per 1 / speed_rate seconds.
+     * int speed_rate: rate the speed is given at, the frame rate the game was tuned for.
+     * int tick_rate: rate the paddle is moved at, the physics rate.
      * 
     */
-    Paddle(int x, int y, int paddle_width, int paddle_height, int paddle_speed);
+    Paddle(int x, int y, int paddle_width, int paddle_height, int paddle_speed, int speed_rate = 1, int tick_rate = 1);
 
     /**
      * Get the SDL_Rect of the paddle. Needed for SDL library functions. Used for collision detection.
@@ -71,22 +93,43 @@ public:
      * 
      * Params:
      * const int& edge: left edge of the screen.
+     * int speed: speed of the move in eighths of the paddle speed, an analog stick moves slower than full_speed.
      */
-    void move_left(const int& edge);
+    void move_left(const int& edge, int speed = full_speed);
 
     /**
      * Move the paddle to the right.
      * 
      * Params:
      * const int& edge: right edge of the screen.
+     * int speed: speed of the move in eighths of the paddle speed, an analog stick moves slower than full_speed.
      */
-    void move_right(const int& edge);
+    void move_right(const int& edge, int speed = full_speed);
 
     /**
      * Reset the paddle to the original position.
      */
     void reset();
 
+    /**
+     * Move the original position of the paddle, for a playfield of another size, and reset the paddle to it.
+     * 
+     * Params:
+     * int x: x position of the left top corner of the paddle.
+     * int y: y position of the left top corner of the paddle.
+     */
+    void set_origin(int x, int y);
+
+    /**
+     * Get the mutable state of the paddle.
+     */
+    State get_state() const;
+
+    /**
+     * Restore a state returned by get_state().
+     */
+    void set_state(const State& state);
+
     /**
      * Get the left edge of the paddle.
      */
@@ -116,6 +159,15 @@ public:
      * Get the height of the paddle.
      */
     int height() const;
+
+private:
+    /**
+     * Distance of a single move in whole pixels, the fraction left over carries to the next move.
+     * 
+     * Params:
+     * int speed: speed of the move in eighths of the paddle speed.
+     */
+    int step(int speed);
 };
 
 #endif // !PADDLE_H
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef PROCEDURAL_LAYOUT_H
+#define PROCEDURAL_LAYOUT_H
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "Brick.h"
+#include "BricksLayout.h"
+
+/**
+ * Symmetry of a procedural level.
+ *
+ * None: every cell is independent.
+ * Mirror: the right half mirrors the left half.
+ * Quad: mirrored left to right and top to bottom.
+ */
+enum class ProceduralSymmetry
+{
+    None,
+    Mirror,
+    Quad
+};
+
+/**
+ * ProceduralLayoutSettings struct holds the settings of a procedural level.
+ *
+ * uint64_t seed: the level, the same seed always gives the same level.
+ * int starting_row, brick_rows, brick_cols, brick_spacing, brick_width, brick_height: the grid of cells, same as
+ *      RowLayoutSettings.
+ * int density: percentage of the cells holding a brick, 0 to 100.
+ * ProceduralSymmetry symmetry: symmetry of the pattern.
+ * int feature_size: size of the blobs of the noise field in cells, 1 for plain noise.
+ */
+struct ProceduralLayoutSettings
+{
+    const uint64_t seed;
+    const int starting_row;
+    const int brick_rows;
+    const int brick_cols;
+    const int brick_spacing;
+    const int brick_width;
+    const int brick_height;
+    const int density = 60;
+    const ProceduralSymmetry symmetry = ProceduralSymmetry::Mirror;
+    const int feature_size = 3;
+};
+
+/**
+ * ProceduralLayout class is a concrete implementation of the BricksLayout interface. Generates a level from a seed.
+ *
+ * Every cell of the grid gets a value from a two octave value noise field seeded by the settings, the cells are
+ * folded onto the fundamental region of the symmetry first so mirrored cells share their value. The cells with the
+ * highest values are filled until the density target is met, mirrored cells are taken together so the pattern
+ * stays symmetric. A second noise field picks the color and points of every brick from a fixed palette.
+ * The noise is integer only with a splitmix64 hash, a seed gives the same level on any platform and compiler.
+ * create_bricks() does not change the layout, any number of threads can generate from the same or separate
+ * instances at once; a level of the default size takes a few microseconds.
+ *
+ * Public Methods:
+ * - ProceduralLayout(): constructor that takes the settings.
+ * - std::pmr::vector<Brick> create_bricks(std::pmr::memory_resource*): generates the bricks.
+ *
+ */
+class ProceduralLayout : public BricksLayout
+{
+    const ProceduralLayoutSettings m_settings;
+
+public:
+    ProceduralLayout(const ProceduralLayoutSettings& settings);
+
+    /**
+     * Generate the bricks of the level, row by row.
+     *
+     * Params:
+     * std::pmr::memory_resource* arena: memory of the returned vector.
+     *
+     * Returns:
+     * std::pmr::vector<Brick>: vector of bricks.
+     */
+    std::pmr::vector<Brick> create_bricks(std::pmr::memory_resource* arena);
+};
+
+#endif // !PROCEDURAL_LAYOUT_H
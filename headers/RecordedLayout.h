@@ -0,0 +1,39 @@
+#ifndef RECORDED_LAYOUT_H
+#define RECORDED_LAYOUT_H
+
+#include <memory_resource>
+#include <vector>
+
+#include "Brick.h"
+#include "BricksLayout.h"
+
+
+/**
+ * RecordedLayout class is a concrete implementation of the BricksLayout interface. Lays out a fixed list of bricks,
+ * like the ones stored in an input log, so a replay runs on exactly the bricks of the recorded game.
+ * 
+ * Public Methods:
+ * - RecordedLayout(): constructor that takes the bricks.
+ * - std::pmr::vector<Brick> create_bricks(std::pmr::memory_resource*): returns a copy of the bricks.
+ * 
+ */
+class RecordedLayout : public BricksLayout
+{
+    const std::vector<Brick> m_bricks;
+
+public:
+    RecordedLayout(const std::vector<Brick>& bricks);
+
+    /**
+     * Create the recorded bricks.
+     * 
+     * Params:
+     * std::pmr::memory_resource* arena: memory of the returned vector.
+     *
+     * Returns:
+     * std::pmr::vector<Brick>: vector of bricks.
+     */
+    std::pmr::vector<Brick> create_bricks(std::pmr::memory_resource* arena);
+};
+
+#endif // !RECORDED_LAYOUT_H
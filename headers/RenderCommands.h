@@ -0,0 +1,191 @@
+#ifndef RENDER_COMMANDS_H
+#define RENDER_COMMANDS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#include "SDL.h"
+
+/**
+ * Layers the render commands are sorted by. Lower layers are submitted first.
+ * Commands inside the same layer are assumed not to overlap, so they can be freely reordered by texture and color.
+ */
+enum class RenderLayer : uint8_t
+{
+    Background = 0,
+    Bricks = 1,
+    Entities = 2,
+    Hud = 3
+};
+
+/**
+ * Compact render command. Either a filled rectangle in a solid color (no texture and no surface) or a textured quad.
+ * Textured quads carry both the GPU texture and the surface it was created from, the accelerated path copies the
+ * texture while the software rasterizer blends the surface pixels.
+ *
+ * SDL_Rect dest: destination rectangle on the screen.
+ * SDL_Rect source: part of the texture and surface copied into dest, empty (w == 0) for all of it. Lets many quads
+ *      share one texture, the glyphs of the score's atlas.
+ * SDL_Texture* texture: texture to copy into dest. nullptr for a fill rect or when there is no accelerated renderer.
+ * SDL_Surface* surface: ARGB8888 source pixels of the quad for the software rasterizer. nullptr for a fill rect.
+ * SDL_Color color: fill color. Ignored for textured quads.
+ * RenderLayer layer: layer the command belongs to.
+ * uint32_t sequence: order in which the command was recorded. Keeps the sort deterministic.
+ */
+struct RenderCommand
+{
+    SDL_Rect dest;
+    SDL_Rect source;
+    SDL_Texture* texture;
+    SDL_Surface* surface;
+    SDL_Color color;
+    RenderLayer layer;
+    uint32_t sequence;
+
+    /**
+     * Whether the command is a fill rect.
+     */
+    bool is_fill() const { return !texture && !surface; }
+};
+
+/**
+ * Statistics of a single submitted frame.
+ *
+ * int commands: number of recorded commands.
+ * int draw_calls: number of SDL draw calls issued. Consecutive fill rects of the same color are batched into one call.
+ * int color_changes: number of SDL_SetRenderDrawColor calls.
+ * int texture_changes: number of times the bound texture changed between consecutive textured quads.
+ */
+struct RenderStats
+{
+    int commands = 0;
+    int draw_calls = 0;
+    int color_changes = 0;
+    int texture_changes = 0;
+
+    /**
+     * Total number of renderer state changes (color + texture) in the frame.
+     */
+    int state_changes() const { return color_changes + texture_changes; }
+};
+
+/**
+ * Per-frame list of render commands.
+ *
+ * The commands live on the frame arena of the Screen, which is reset at the start of every frame: resetting the list
+ * takes a new block of the largest capacity any frame needed from the arena. A frame recording more commands than
+ * ever before grows (doubles) the storage within the arena, the arena then grows its block at the next reset, so
+ * after the first few frames recording does not allocate.
+ * Before submission the list is sorted by layer, texture and color so redundant SDL_SetRenderDrawColor calls and
+ * texture switches are dropped and runs of same colored rects are drawn with a single SDL_RenderFillRects call.
+ *
+ * std::pmr::memory_resource* m_arena: the frame arena.
+ * std::pmr::vector<RenderCommand> m_commands: commands recorded this frame.
+ * std::pmr::vector<SDL_Rect> m_batch: scratch storage for batching fill rects of the same color.
+ * size_t m_capacity: number of commands reserved every frame, the most any frame recorded.
+ *
+ * Public Methods:
+ *  - void reset(): forget all recorded commands, after the frame arena was reset.
+ *  - void fill_rect(): record a filled rectangle.
+ *  - void textured_quad(): record a texture copy.
+ *  - void sort(): sort the commands by layer, texture and color.
+ *  - RenderStats submit(): sort the commands and issue them to the SDL renderer.
+ *  - const RenderCommand* data(): recorded commands, in submission order once sorted.
+ *  - size_t size(): number of recorded commands.
+ *  - size_t capacity(): number of commands that can be recorded without growing.
+ *
+ */
+class RenderCommandList
+{
+    std::pmr::memory_resource* m_arena;
+    std::pmr::vector<RenderCommand> m_commands;
+    std::pmr::vector<SDL_Rect> m_batch;
+    size_t m_capacity;
+
+public:
+    RenderCommandList(const RenderCommandList&) = delete;
+    RenderCommandList& operator=(const RenderCommandList&) = delete;
+
+    /**
+     * Constructor for the RenderCommandList class.
+     *
+     * Params:
+     * std::pmr::memory_resource* arena: the frame arena, reset before every reset() of the list.
+     * size_t initial_capacity: number of commands to reserve.
+     */
+    RenderCommandList(std::pmr::memory_resource* arena, size_t initial_capacity = 256);
+
+    /**
+     * Forget all recorded commands and reserve the storage of a frame from the arena. Call right after the arena
+     * was reset, the old storage went with it.
+     */
+    void reset();
+
+    /**
+     * Record a filled rectangle.
+     *
+     * Params:
+     * const SDL_Rect& dest: rectangle to fill.
+     * SDL_Color color: fill color.
+     * RenderLayer layer: layer of the rectangle.
+     */
+    void fill_rect(const SDL_Rect& dest, SDL_Color color, RenderLayer layer);
+
+    /**
+     * Record a copy of the texture into the destination rectangle. Ignored if both texture and surface are null.
+     *
+     * Params:
+     * SDL_Texture* texture: texture to copy. Must stay alive until the list is submitted.
+     * SDL_Surface* surface: ARGB8888 pixels of the texture for the software rasterizer, may be null. Must stay alive too.
+     * const SDL_Rect& dest: destination rectangle.
+     * RenderLayer layer: layer of the quad.
+     * const SDL_Rect& source: part of the texture to copy. Default is empty, the whole texture.
+     */
+    void textured_quad(SDL_Texture* texture, SDL_Surface* surface, const SDL_Rect& dest, RenderLayer layer, const SDL_Rect& source = SDL_Rect{0, 0, 0, 0});
+
+    /**
+     * Sort the commands by layer, source texture, color and recording order.
+     */
+    void sort();
+
+    /**
+     * Sort the recorded commands and issue them to the renderer.
+     *
+     * Params:
+     * SDL_Renderer* renderer: renderer to draw with.
+     * SDL_Color current_color: draw color the renderer is set to before the submission.
+     *
+     * Returns:
+     * RenderStats: statistics of the submission.
+     *
+     * Throws:
+     * std::runtime_error: if any of the SDL draw calls fails.
+     */
+    RenderStats submit(SDL_Renderer* renderer, SDL_Color current_color);
+
+    /**
+     * Get the recorded commands. Sorted after sort() or submit().
+     */
+    const RenderCommand* data() const;
+
+    /**
+     * Number of recorded commands.
+     */
+    size_t size() const;
+
+    /**
+     * Number of commands that can be recorded without growing the storage.
+     */
+    size_t capacity() const;
+
+private:
+    /**
+     * Reserve a slot for a new command, growing the storage if needed.
+     */
+    RenderCommand& push();
+};
+
+#endif // !RENDER_COMMANDS_H
@@ -1,10 +1,16 @@
 #ifndef ROW_LAYOUT_H
 #define ROW_LAYOUT_H
 
+#include <array>
+#include <cstddef>
+#include <memory_resource>
 #include <vector>
 
+#include "SDL.h"
+
 #include "Brick.h"
 #include "BricksLayout.h"
+#include "StaticLayout.h"
 
 
 /**
@@ -29,13 +35,60 @@ struct RowLayoutSettings
 };
 
 
+/**
+ * Describe the brick of a row layout at the given row and column. Each row has alternating colors and points.
+ * Shared by RowLayout at runtime and make_row_bricks() at compile time.
+ * 
+ * Params:
+ * const RowLayoutSettings& settings: settings of the layout.
+ * int row, col: position of the brick in the grid.
+ * 
+ * Returns:
+ * BrickData: the brick.
+ */
+constexpr BrickData row_brick(const RowLayoutSettings& settings, int row, int col)
+{
+    const bool even = row % 2 == 0;     // alternate colors and points for each row
+    return BrickData{
+        col * settings.brick_width,
+        (settings.starting_row + row) * settings.brick_height,
+        settings.brick_width - settings.brick_spacing,
+        settings.brick_height - settings.brick_spacing,
+        even ? 10 : 20,
+        even ? SDL_Color{ 255, 0, 0, 255 } : SDL_Color{ 255, 255, 0, 255 }
+    };
+}
+
+/**
+ * Lay out the bricks of a row layout at compile time. Pass the result to a StaticLayout, e.g.
+ *  static constexpr auto bricks = make_row_bricks<RowLayoutSettings{2, 4, 10, 10, 80, 30}>();
+ * 
+ * Returns:
+ * std::array<BrickData, rows * cols>: the bricks row by row, same as RowLayout::create_bricks().
+ */
+template <RowLayoutSettings Settings>
+constexpr std::array<BrickData, static_cast<size_t>(Settings.brick_rows * Settings.brick_cols)> make_row_bricks()
+{
+    std::array<BrickData, static_cast<size_t>(Settings.brick_rows * Settings.brick_cols)> bricks{};
+    for (int row = 0; row < Settings.brick_rows; row++)
+    {
+        for (int col = 0; col < Settings.brick_cols; col++)
+        {
+            bricks[row * Settings.brick_cols + col] = row_brick(Settings, row, col);
+        }
+    }
+    return bricks;
+}
+
+
 /**
  * RowLayout class is a concrete implementation of the BricksLayout interface. Layouts the bricks in rows.
- * Passed to the ArkanoidGame class using polymorphism.
+ * Passed to the ArkanoidGame class using polymorphism. For settings known at compile time prefer make_row_bricks()
+ * with a StaticLayout.
  * 
  * Public Methods:
  * - RowLayout(): constructor that takes a layout settings.
- * - std::vector<Brick> create_bricks(): creates the bricks in rows.
+ * - std::pmr::vector<Brick> create_bricks(std::pmr::memory_resource*): creates the bricks in rows.
  * 
  */
 
@@ -49,10 +102,13 @@ public:
     /**
      * Create the bricks in rows. Each row has alternating colors and points.
      * 
+     * Params:
+     * std::pmr::memory_resource* arena: memory of the returned vector.
+     *
      * Returns:
-     * std::vector<Brick>: vector of bricks.
+     * std::pmr::vector<Brick>: vector of bricks.
      */
-    std::vector<Brick> create_bricks();
+    std::pmr::vector<Brick> create_bricks(std::pmr::memory_resource* arena);
 };
 
 #endif // !ROW_LAYOUT_H
\ No newline at end of file
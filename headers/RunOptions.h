@@ -0,0 +1,129 @@
+#ifndef RUN_OPTIONS_H
+#define RUN_OPTIONS_H
+
+#include <cstdint>
+#include <string>
+
+#include "FrameLimiter.h"
+
+/**
+ * Renderer backing the Screen.
+ *
+ * Accelerated: SDL renderer, the default.
+ * Software: in-house SoftwareRasterizer, presented to the window through a streaming texture.
+ * Headless: SoftwareRasterizer without any window, nothing is presented.
+ */
+enum class RendererType
+{
+    Accelerated,
+    Software,
+    Headless
+};
+
+/**
+ * RunOptions
+ *
+ * Options of a single run of the program, parsed from the command line. Unlike GameSettings these do not change
+ * the game itself, only how it is run.
+ *
+ * RendererType renderer: renderer backing the screen. --renderer=accelerated|software|headless
+ * int raster_threads: threads used by the software rasterizer. --raster-threads=N, 0 means all hardware threads.
+ * std::string capture_path: record the presented frames into this .y4m file, empty for no capture. --capture=PATH
+ * int capture_ring: number of frames buffered for the capture worker before frames are dropped. --capture-ring=N
+ * std::string record_input_path: record the input of every tick into this log, empty for no recording. --record-input=PATH
+ * std::string replay_input_path: play the input of this log instead of reading the keyboard. --replay-input=PATH
+ *      The game is rebuilt from the log: its settings, bricks and seed replace the ones of the command line.
+ * int keyframe_interval: seconds of game time between the keyframes of a recorded log. --keyframe-interval=SECONDS
+ * int replay_seek: start the replay this many seconds of game time into the log. --replay-seek=SECONDS
+ *      During a replay the left and right arrows seek 10 seconds back and forth.
+ * uint64_t seed: seed of the game's random generator. --seed=N, random by default, 1 for --benchmark.
+ * std::string export_path: render the replayed session headless as fast as possible into this .y4m file. --export=PATH
+ *      Requires --replay-input, implies --renderer=headless and --virtual-time.
+ * int export_threads: threads encoding the exported video. --export-threads=N, 0 (default) means all hardware threads.
+ * FramePacing pacing: where the frame limiter waits. --pacing=steady|low-latency
+ * int window_width, window_height: resolution of the window, and of the playfield without a level. --window=WxH
+ * int layout_rows, layout_cols: rows and columns of bricks. --layout=ROWSxCOLS
+ * std::string level_path: play this level instead of the rows of --layout, empty for none. --level=PATH
+ *      A binary level (BinaryLevelLayout) or a text one (TextLayout). The playfield takes the size the level was made for,
+ *      the window is --window at most and scrolls over a larger playfield.
+ * std::string level_pack_path: play the levels of this pack one after another, empty for none. --level-pack=PATH
+ *      See LevelPack. Takes the place of --level, the playfield takes the size of the first level. Not with --record-input,
+ *      a log holds the bricks of a single level; ignored when replaying.
+ * bool watch_level: reload the level being played whenever its file changes, see LevelWatcher. --watch-level
+ *      Needs --level or --level-pack. Not with --record-input; ignored when replaying.
+ * bool procedural: generate the bricks of the --layout grid with a ProceduralLayout. --procedural=SEED
+ * uint64_t procedural_seed: seed of the generated level.
+ * int procedural_density: percentage of the grid cells holding a brick. --procedural-density=PERCENT
+ * bool benchmark: play a scripted game as fast as possible and write a report. --benchmark
+ *      Implies --virtual-time, the game restarts until the frames were played.
+ * uint64_t benchmark_frames: number of frames of the benchmark run. --benchmark-frames=N
+ * std::string benchmark_report_path: JSON report of the benchmark run. --benchmark-report=PATH
+ * bool alloc_check: play the benchmark game and fail the run (exit code 1) if any frame of the game loop allocates
+ *      after the warm-up, see AllocationCounter. --alloc-check, implies --benchmark. Needs a build with
+ *      ARKANOID_COUNT_ALLOCATIONS.
+ * bool virtual_time: run the game on a VirtualClock. Frames are paced and simulated as at GameSettings::fps_limit
+ *      but never wait, a session plays as fast as the CPU allows. --virtual-time, implied by --export and --benchmark.
+ * std::string frame_stats_csv_path: stream per second frame time percentiles into this CSV file. --frame-stats-csv=PATH
+ * bool gamepad: read the first attached game controller on a background thread. --no-gamepad disables it. Always off
+ *      when headless, replaying or on virtual time.
+ * int gamepad_deadzone: stick deflection read as centered, 0 to 32767. --gamepad-deadzone=N
+ * bool idle_rendering: block on SDL events instead of redrawing every frame while nothing can change on screen
+ *      (end screen, ball waiting on the paddle). --no-idle disables it. Always off when headless, replaying, capturing
+ *      or on virtual time.
+ */
+struct RunOptions
+{
+    RendererType renderer = RendererType::Accelerated;
+    int raster_threads = 1;
+    std::string capture_path;
+    int capture_ring = 8;
+    std::string record_input_path;
+    std::string replay_input_path;
+    int keyframe_interval = 5;
+    int replay_seek = 0;
+    uint64_t seed = 0;
+    std::string export_path;
+    int export_threads = 0;
+    std::string frame_stats_csv_path;
+    FramePacing pacing = FramePacing::Steady;
+    int window_width = 800;
+    int window_height = 600;
+    int layout_rows = 4;
+    int layout_cols = 10;
+    std::string level_path;
+    std::string level_pack_path;
+    bool watch_level = false;
+    bool procedural = false;
+    uint64_t procedural_seed = 0;
+    int procedural_density = 60;
+    bool benchmark = false;
+    uint64_t benchmark_frames = 3000;
+    std::string benchmark_report_path = "benchmark.json";
+    bool alloc_check = false;
+    bool virtual_time = false;
+    bool gamepad = true;
+    int gamepad_deadzone = 8000;
+    bool idle_rendering = true;
+};
+
+/**
+ * Get the command line name of a renderer type.
+ */
+const char* renderer_name(RendererType renderer);
+
+/**
+ * Parse the run options from the command line arguments.
+ *
+ * Params:
+ * int argc: number of arguments.
+ * char* argv[]: arguments, argv[0] is the program name.
+ *
+ * Returns:
+ * RunOptions: parsed options, defaults for the ones not given.
+ *
+ * Throws:
+ * std::runtime_error: on an unknown argument or an invalid value.
+ */
+RunOptions parse_run_options(int argc, char* argv[]);
+
+#endif // !RUN_OPTIONS_H
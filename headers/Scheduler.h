@@ -0,0 +1,111 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Multi-rate scheduler of the game subsystems.
+ *
+ * Every task declares its own rate. Once per loop iteration the game asks each task how many of its steps came due
+ * since the last iteration and runs exactly that many, work that is not due is skipped. Deadlines advance by whole
+ * periods, so a task runs at its exact long run rate whatever the frame rate of the loop is. A task that fell
+ * further behind than its step limit (after a hitch or an idle wait) runs the limit, drops the rest and resyncs to
+ * the current time instead of spiraling.
+ *
+ * std::vector<Task> m_tasks: registered tasks, indexed by the id returned from add_task().
+ *
+ * Public Methods:
+ *  - int add_task(): register a task with a rate.
+ *  - int due(): number of steps of a task due by the given time, advances its deadline.
+ *  - uint64_t get_step_time(): time a step returned by the last due() was due at.
+ *  - void resync(): restart the deadlines of all tasks at the given time.
+ *  - uint64_t get_steps(), get_dropped(): steps run and dropped by a task so far.
+ *  - void log_summary(): log the rate and steps of every task.
+ *
+ */
+class Scheduler
+{
+    /**
+     * A scheduled subsystem.
+     */
+    struct Task
+    {
+        const char* name;
+        int rate;                   // steps per second
+        uint64_t period;            // nanoseconds between steps
+        int max_steps;              // most steps run in one iteration
+        uint64_t next = 0;          // deadline of the next step, 0 before the first call to due()
+        uint64_t first_due = 0;     // deadline of the first step returned by the last call to due()
+        uint64_t steps = 0;         // steps run
+        uint64_t dropped = 0;       // steps dropped after falling behind
+    };
+
+    std::vector<Task> m_tasks;
+
+public:
+    /**
+     * Register a task.
+     *
+     * Params:
+     * const char* name: name of the task for the log, MUST outlive the scheduler.
+     * int rate: steps per second. Values below 1 mean 1.
+     * int max_steps: most steps run in one iteration, the rest is dropped. 1 coalesces missed steps into one.
+     *
+     * Returns:
+     * int: id of the task.
+     */
+    int add_task(const char* name, int rate, int max_steps = 1);
+
+    /**
+     * Get the number of steps of a task due by the given time and advance its deadline past them.
+     * The first call for a task returns a single step.
+     *
+     * Params:
+     * int task: id of the task.
+     * uint64_t now: current time in nanoseconds.
+     *
+     * Returns:
+     * int: steps to run now, 0 when the task is not due.
+     */
+    int due(int task, uint64_t now);
+
+    /**
+     * Get the time a step returned by the last call to due() was due at. Fixed rate subsystems use it to work
+     * out what happened by then, like the input of a physics step.
+     *
+     * Params:
+     * int task: id of the task.
+     * int step: index of the step among the ones returned by due().
+     *
+     * Returns:
+     * uint64_t: time in nanoseconds.
+     */
+    uint64_t get_step_time(int task, int step) const;
+
+    /**
+     * Restart the deadlines of all tasks at now, one step of each is due right away. Used after the game idled,
+     * the time spent waiting is not caught up on.
+     *
+     * Params:
+     * uint64_t now: current time in nanoseconds.
+     */
+    void resync(uint64_t now);
+
+    /**
+     * Get the number of steps a task ran.
+     */
+    uint64_t get_steps(int task) const;
+
+    /**
+     * Get the number of steps a task dropped after falling behind.
+     */
+    uint64_t get_dropped(int task) const;
+
+    /**
+     * Log the rate, steps run and steps dropped of every task.
+     */
+    void log_summary() const;
+};
+
+#endif // !SCHEDULER_H
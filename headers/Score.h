@@ -6,6 +6,8 @@
 #include <string_view>
 #include <optional>
 #include <cassert>
+#include <array>
+#include <vector>
 
 #include "SDL.h"
 #include "SDL_ttf.h"
@@ -15,17 +17,35 @@
 /**
  * RAII for SDL resources needed to render score on screen.
  * 
- * Score is rendered onto a surface, which is then rendered onto a texture on screen.
+ * The printable ASCII glyphs are rendered once per font size and color into an atlas, a surface (and a texture when
+ * the screen draws with textures) holding them side by side. Preparing a text only lays out its glyphs into a fixed
+ * array of atlas and screen rectangles, drawing it records a quad per glyph sharing the atlas texture. Score updates
+ * thus neither render text nor allocate, the atlases of the HUD and the end screen are built on first use and kept.
+ * Other characters are drawn as '?', '\n' starts a new line, texts are cut at max_text_length characters.
+ * 
+ * GlyphAtlas: glyphs of one font size and color.
+ *  - int font_size: size of the font.
+ *  - SDL_Color color: color of the glyphs.
+ *  - std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)> surface: ARGB8888 pixels of the glyphs.
+ *  - std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> texture: the surface as a texture, null for the
+ *      software renderers.
+ *  - std::array<SDL_Rect, glyph_count> glyphs: rectangle of every glyph in the atlas.
+ *  - std::array<int, glyph_count> advances: how far every glyph moves the pen.
+ *  - int height, line_skip: height of the font and distance of two lines.
+ * 
+ * Glyph: a laid out glyph, its rectangle in the atlas and on the screen relative to the text box.
  * 
  * std::unique_ptr<TTF_Font, decltype(&TTF_CloseFont)> m_font_ptr: unique_ptr to the font resource. 
  *      Held for the entire run, just changing the font size. Font is loaded from the assets folder.
- * std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)> m_text_ptr: unique_ptr to the surface resource.
- *      Surface is created from the font and the text to render. Cleared and reinitilized every score update.
- * std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> m_text_texture_ptr: unique_ptr to the texture resource.
- *      Texture is created from the surface. Cleared and reinitilized every score update.
+ * std::vector<GlyphAtlas> m_atlases: atlases built so far.
+ * int m_atlas: index of the atlas of the prepared text, -1 for none.
+ * std::array<Glyph, max_text_length> m_glyphs: the prepared text.
+ * size_t m_glyph_count: number of glyphs of the prepared text.
+ * int m_text_width, m_text_height: size of the prepared text box.
  * 
  * const char* m_score_format_string: format string for the score.
  * int m_font_size: size of the font.
+ * int m_current_font_size: size the font is set to.
  * int m_num_balls: number of balls the player has.
  * 
  * int m_points: number of points the player has.
@@ -34,11 +54,41 @@
  */
 class Score
 {
+public:
+    static constexpr char first_glyph = ' ';
+    static constexpr char last_glyph = '~';
+    static constexpr size_t glyph_count = last_glyph - first_glyph + 1;
+    static constexpr size_t max_text_length = 128;
+
+private:
+    struct GlyphAtlas
+    {
+        int font_size = 0;
+        SDL_Color color{0, 0, 0, 0};
+        std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)> surface{nullptr, SDL_FreeSurface};
+        std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> texture{nullptr, SDL_DestroyTexture};
+        std::array<SDL_Rect, glyph_count> glyphs{};
+        std::array<int, glyph_count> advances{};
+        int height = 0;
+        int line_skip = 0;
+    };
+
+    struct Glyph
+    {
+        SDL_Rect source;
+        SDL_Rect dest;
+    };
+
     std::unique_ptr<TTF_Font, decltype(&TTF_CloseFont)> m_font_ptr{nullptr, TTF_CloseFont};
-    std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)> m_text_ptr{nullptr, SDL_FreeSurface};
-    std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> m_text_texture_ptr{nullptr, SDL_DestroyTexture};
+    std::vector<GlyphAtlas> m_atlases;
+    int m_atlas = -1;
+    std::array<Glyph, max_text_length> m_glyphs{};
+    size_t m_glyph_count = 0;
+    int m_text_width = 0;
+    int m_text_height = 0;
     const char* m_score_format_string = "Score: %d | Lives: %d";
     int m_font_size;
+    int m_current_font_size;
     int m_num_balls;
 
 public:
@@ -81,8 +131,10 @@ public:
      * 
      * Params:
      * Screen& screen: screen to draw the score on.
-     * Score& score: score structure containing the font, surface and texture to prepare.
      * const SDL_Color& color: color of the text.
+     *
+     * Throws:
+     * std::runtime_error: if the glyph atlas could not be created.
      */
     void prepare(Screen& screen, const SDL_Color& color);
 
@@ -93,6 +145,9 @@ public:
      * Screen& screen: screen to draw the score on.
      * const std::string_view status_string: string to render.
      * const SDL_Color& color: color of the text.
+     *
+     * Throws:
+     * std::runtime_error: if the glyph atlas could not be created.
      */
     void prepare(Screen& screen, const std::string_view status_string, const SDL_Color& color);
 
@@ -134,6 +189,28 @@ public:
      * Reset the score to the original values.
      */
     void reset();
+
+private:
+    /**
+     * Lay out the glyphs of the text with the atlas of the current font size and the color.
+     * 
+     * Params:
+     * Screen& screen: screen the text is going to be drawn on.
+     * const std::string_view text: text to lay out.
+     * const SDL_Color& color: color of the text.
+     */
+    void layout_text(Screen& screen, const std::string_view text, const SDL_Color& color);
+
+    /**
+     * Get the atlas of the current font size and the color, rendering it if there is none yet.
+     * 
+     * Returns:
+     * int: index of the atlas in m_atlases.
+     *
+     * Throws:
+     * std::runtime_error: if the atlas surface or texture could not be created.
+     */
+    int find_atlas(Screen& screen, const SDL_Color& color);
 };
 
 #endif // !SCORE_H
\ No newline at end of file
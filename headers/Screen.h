@@ -5,32 +5,75 @@
 #include <memory>
 #include <string_view>
 #include <cassert>
+#include <cstdint>
+#include <memory_resource>
 
 #include "SDL.h"
 
+#include "Arena.h"
+#include "RenderCommands.h"
+#include "SoftwareRasterizer.h"
+#include "RunOptions.h"
+
 /**
  * RAII for SDL resources needed to render score on screen.
  * 
  * Using unique_ptr to manage the resources. The ptr is instantiated with SDL_Destroy passed to it to invoke when destruction
  * occurs. However, beacause of c++ dtor ordering, we have to manually invoke the destruction before SDL_Quit.
  * 
+ * The frame is drawn either by the SDL renderer (RendererType::Accelerated) or by the in-house SoftwareRasterizer.
+ * The software frame is presented through a streaming texture (RendererType::Software) or not at all when there is no
+ * window (RendererType::Headless).
+ * 
+ * The game is drawn in playfield (world) coordinates through a camera: the window shows the width() x height()
+ * rectangle of the playfield at the camera (get_view()), to_screen() moves a rectangle of the playfield into window
+ * coordinates. The playfield is the size of the window unless set_playfield() makes it larger; the HUD is drawn in
+ * window coordinates directly.
+ * 
  * int m_width: width of the screen.
  * int m_height: height of the screen.
- * std::unique_ptr<SDL_Window, decltype(&SDL_DestroyWindow)> m_window_ptr: unique_ptr to the window resource.
- * std::unique_ptr<SDL_Renderer, decltype(&SDL_DestroyRenderer)> m_renderer_ptr: unique_ptr to the renderer resource.
+ * int m_playfield_width, m_playfield_height: size of the playfield.
+ * int m_camera_x, m_camera_y: top left corner of the playfield area shown in the window.
+ * RendererType m_renderer_type: renderer backing the screen.
+ * std::unique_ptr<SDL_Window, decltype(&SDL_DestroyWindow)> m_window_ptr: unique_ptr to the window resource. Null when headless.
+ * std::unique_ptr<SDL_Renderer, decltype(&SDL_DestroyRenderer)> m_renderer_ptr: unique_ptr to the renderer resource. Null when headless.
+ * std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> m_stream_texture_ptr: streaming texture presenting
+ *      the software framebuffer. Only used by RendererType::Software.
+ * std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> m_target_texture_ptr: offscreen render target the
+ *      accelerated renderer draws into when the frame needs to be read back. Null otherwise.
+ * std::unique_ptr<SoftwareRasterizer> m_rasterizer: software rasterizer. Null for RendererType::Accelerated.
+ * bool m_rendered: the recorded commands of the current frame were already rendered.
+ * Arena m_frame_arena: memory of the current frame, reset by clear(). Holds the render commands.
+ * RenderCommandList m_commands: commands recorded for the current frame. Submitted in one go by present().
+ * SDL_Color m_clear_color: background color of the current frame.
+ * RenderStats m_render_stats: statistics of the last presented frame.
  * 
  * Public Methods:
  *  - Screen(): constructor for the Screen class.
- *  - clear(): clear the screen with a background color.
- *  - present(): present the screen to display.
+ *  - clear(): start a new frame with a background color.
+ *  - fill_rect(): record a filled rectangle for the current frame.
+ *  - draw_texture(): record a texture copy for the current frame.
+ *  - render(): submit the recorded commands without presenting.
+ *  - present(): submit the recorded commands if not done yet and present the screen to display.
+ *  - enable_readback(): render offscreen so that the frame can be read back.
+ *  - read_pixels(): read back the rendered frame.
+ *  - get_render_stats(): get the statistics of the last presented frame.
+ *  - get_frame_arena(): memory for data living until the next frame.
+ *  - uses_textures(): whether textured quads need an SDL_Texture (accelerated) or only their surface (software).
+ *  - get_renderer_type(): get the renderer backing the screen.
  * 
  *  - width(): get the width of the screen.
  *  - height(): get the height of the screen.
  * 
- *  - left(): get the left edge of the screen.
- *  - right(): get the right edge of the screen.
- *  - top(): get the top edge of the screen.
- *  - bottom(): get the bottom edge of the screen.
+ *  - left(): get the left edge of the playfield.
+ *  - right(): get the right edge of the playfield.
+ *  - top(): get the top edge of the playfield.
+ *  - bottom(): get the bottom edge of the playfield.
+ * 
+ *  - set_playfield(): set the size of the playfield.
+ *  - look_at(): move the camera to center a point of the playfield.
+ *  - get_view(): get the area of the playfield shown in the window.
+ *  - to_screen(): transform a rectangle of the playfield into window coordinates.
  * 
  *  - make_resizable(): set the window as resizable in the x and y directions by an integer factor.
  * 
@@ -42,8 +85,21 @@ class Screen
 {
     int m_width;
     int m_height;
+    int m_playfield_width;
+    int m_playfield_height;
+    int m_camera_x = 0;
+    int m_camera_y = 0;
+    RendererType m_renderer_type;
     std::unique_ptr<SDL_Window, decltype(&SDL_DestroyWindow)> m_window_ptr {nullptr, SDL_DestroyWindow};
     std::unique_ptr<SDL_Renderer, decltype(&SDL_DestroyRenderer)> m_renderer_ptr {nullptr, SDL_DestroyRenderer};
+    std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> m_stream_texture_ptr {nullptr, SDL_DestroyTexture};
+    std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> m_target_texture_ptr {nullptr, SDL_DestroyTexture};
+    std::unique_ptr<SoftwareRasterizer> m_rasterizer;
+    bool m_rendered = false;
+    Arena m_frame_arena{64 * 1024};
+    RenderCommandList m_commands{&m_frame_arena};
+    SDL_Color m_clear_color {0, 0, 0, 255};
+    RenderStats m_render_stats;
 
 public:
     Screen(const Screen&) = delete;             // no copy 
@@ -56,29 +112,116 @@ public:
      * - std::string window_name: name of the window.
      * - int width: width of the window.
      * - int height: height of the window.
+     * - RendererType renderer_type: renderer backing the screen.
+     * - int raster_threads: number of threads of the software rasterizer. Unused by the accelerated renderer.
      * 
      * Throws:
      * std::runtime_error: on any of:
      *      - SDL library could not be initialized, 
      *      - window could not be created, 
-     *      - renderer could not be created.
+     *      - renderer could not be created,
+     *      - streaming texture could not be created.
      * 
      */
-    Screen(const std::string_view window_name, int width, int height);
+    Screen(
+        const std::string_view window_name, 
+        int width, 
+        int height, 
+        RendererType renderer_type = RendererType::Accelerated, 
+        int raster_threads = 1
+    );
 
     /**
-     * Clear the screen with a background color.
+     * Start a new frame. Drops the commands recorded so far and sets the background color of the frame.
      * 
      * Parameters:
      * - SDL_Color clr: base color of the screen background.
      */
     void clear(SDL_Color clr = {0, 0, 0, 255});
 
+    /**
+     * Record a filled rectangle to be drawn when the frame is presented.
+     * 
+     * Parameters:
+     * - const SDL_Rect& rect: rectangle to fill.
+     * - SDL_Color color: fill color.
+     * - RenderLayer layer: layer of the rectangle. Lower layers are drawn first.
+     */
+    void fill_rect(const SDL_Rect& rect, SDL_Color color, RenderLayer layer);
+
+    /**
+     * Record a texture copy to be drawn when the frame is presented.
+     * 
+     * Parameters:
+     * - SDL_Texture* texture: texture to draw. Must stay alive until the frame is presented. May be null if !uses_textures().
+     * - SDL_Surface* surface: ARGB8888 pixels of the texture used by the software rasterizer. Must stay alive as well.
+     * - const SDL_Rect& dest: destination rectangle.
+     * - RenderLayer layer: layer of the texture. Lower layers are drawn first.
+     * - const SDL_Rect& source: part of the texture to draw. Default is empty, the whole texture.
+     */
+    void draw_texture(SDL_Texture* texture, SDL_Surface* surface, const SDL_Rect& dest, RenderLayer layer, const SDL_Rect& source = SDL_Rect{0, 0, 0, 0});
+
+    /**
+     * Render the recorded frame without presenting it. Clears the renderer and submits the recorded commands sorted
+     * by layer, texture and color. Does nothing if the frame was already rendered.
+     * 
+     * Throws:
+     * std::runtime_error: if any of the SDL draw calls fails.
+     */
+    void render();
+
     /**
      * Present the screen to the user. To be called after all drawing operations.
+     * Renders the frame first if render() was not called yet.
+     * 
+     * Throws:
+     * std::runtime_error: if any of the SDL draw calls fails.
      */
     void present();
 
+    /**
+     * Make the rendered frames readable with read_pixels(). The accelerated renderer then draws into an offscreen
+     * target texture which is copied to the window on present. The software framebuffer is always readable.
+     * 
+     * Throws:
+     * std::runtime_error: if the offscreen target could not be created.
+     */
+    void enable_readback();
+
+    /**
+     * Read back the frame rendered by render(). Only valid between render() and present().
+     * 
+     * Parameters:
+     * - uint32_t* pixels: destination of width() x height() ARGB8888 pixels.
+     * - int pitch: length of a destination row in bytes.
+     * 
+     * Returns:
+     * - bool: false if there is no rendered frame or readback was not enabled.
+     */
+    bool read_pixels(uint32_t* pixels, int pitch);
+
+    /**
+     * Get the statistics of the last presented frame (commands, draw calls and state changes).
+     */
+    const RenderStats& get_render_stats() const;
+
+    /**
+     * Get the frame arena, memory for transient data of the frame being recorded. Everything allocated from it is
+     * gone with the next clear(), and once the arena grew to what a frame needs it does not touch the heap.
+     */
+    std::pmr::memory_resource* get_frame_arena();
+
+    /**
+     * Whether textured quads are drawn from an SDL_Texture. False for the software renderers, which only need the
+     * ARGB8888 surface of the quad.
+     */
+    bool uses_textures() const;
+
+    /**
+     * Get the renderer backing the screen.
+     */
+    RendererType get_renderer_type() const;
+
     /**
      * Get the width of the screen.
      */
@@ -90,27 +233,54 @@ public:
     int height() const;
 
     /**
-     * Get the left edge of the screen.
+     * Get the left edge of the playfield.
      */
     int left() const;
 
     /**
-     * Get the right edge of the screen.
+     * Get the right edge of the playfield.
      */
     int right() const;
 
     /**
-     * Get the top edge of the screen.
+     * Get the top edge of the playfield.
      */
     int top() const;
 
     /**
-     * Get the bottom edge of the screen.
+     * Get the bottom edge of the playfield.
      */
     int bottom() const;
 
     /**
-     * Set the window as resizable in the x and y directions by an integer factor.
+     * Set the size of the playfield, at least the size of the window. The camera is moved back into it.
+     * 
+     * Parameters:
+     * - int width, height: size of the playfield.
+     */
+    void set_playfield(int width, int height);
+
+    /**
+     * Move the camera so that a point of the playfield is in the center of the window, as far as the edges of the
+     * playfield allow.
+     * 
+     * Parameters:
+     * - int x, y: the point in playfield coordinates.
+     */
+    void look_at(int x, int y);
+
+    /**
+     * Get the area of the playfield shown in the window.
+     */
+    SDL_Rect get_view() const;
+
+    /**
+     * Transform a rectangle of the playfield into window coordinates.
+     */
+    SDL_Rect to_screen(const SDL_Rect& rect) const;
+
+    /**
+     * Set the window as resizable in the x and y directions by an integer factor. No-op when headless.
      */
     void make_resizable();
 
@@ -120,7 +290,7 @@ public:
      * Necessary because the SDL library requires raw pointers for its operations.
      * 
      * Returns:
-     * - SDL_Window*: raw pointer to the window, still managed by the unique_ptr.
+     * - SDL_Window*: raw pointer to the window, still managed by the unique_ptr. Null when headless.
      */
     SDL_Window* get_window_ptr_raw();
 
@@ -130,7 +300,7 @@ public:
      * Necessary because the SDL library requires raw pointers for its operations.
      * 
      * Returns:
-     * - SDL_Window*: raw pointer to the window, still managed by the unique_ptr.
+     * - SDL_Renderer*: raw pointer to the renderer, still managed by the unique_ptr. Null when headless.
      */
     SDL_Renderer* get_renderer_ptr_raw();
 
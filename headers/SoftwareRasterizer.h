@@ -0,0 +1,105 @@
+#ifndef SOFTWARE_RASTERIZER_H
+#define SOFTWARE_RASTERIZER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+#include "SDL.h"
+
+#include "RenderCommands.h"
+#include "WorkerPool.h"
+
+/**
+ * CPU rasterizer executing a sorted RenderCommandList into a 32-bit ARGB8888 framebuffer.
+ *
+ * Meant for machines without an accelerated renderer (CI, headless render farms) where SDL's own software fallback
+ * is slow. Opaque rects are filled span by span with AVX2 stores when the CPU supports it, textured quads are
+ * alpha-blended from their ARGB8888 source surface (glyphs rendered by SDL_ttf).
+ * The framebuffer can be split into horizontal bands rasterized in parallel, each band runs the whole command list
+ * clipped to itself so no synchronisation between the bands is needed.
+ *
+ * int m_width: width of the framebuffer in pixels.
+ * int m_height: height of the framebuffer in pixels.
+ * std::unique_ptr<uint32_t[]> m_pixels: framebuffer, rows are tightly packed.
+ * WorkerPool m_pool: threads rasterizing the bands.
+ * int m_bands: number of bands the framebuffer is split into.
+ *
+ * Public Methods:
+ *  - void render(): clear the framebuffer and execute the commands.
+ *  - const uint32_t* pixels(): framebuffer pixels.
+ *  - int pitch(): length of a framebuffer row in bytes.
+ *  - int width(), height(): size of the framebuffer.
+ *
+ */
+class SoftwareRasterizer
+{
+    int m_width;
+    int m_height;
+    std::unique_ptr<uint32_t[]> m_pixels;
+    WorkerPool m_pool;
+    int m_bands;
+
+public:
+    SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+    SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+
+    /**
+     * Constructor for the SoftwareRasterizer class.
+     *
+     * Params:
+     * int width: width of the framebuffer.
+     * int height: height of the framebuffer.
+     * int threads: number of threads rasterizing the framebuffer bands. 1 rasterizes on the calling thread only.
+     */
+    SoftwareRasterizer(int width, int height, int threads = 1);
+
+    /**
+     * Clear the framebuffer and execute the commands in order. The commands are expected to be sorted already.
+     *
+     * Params:
+     * const RenderCommand* commands: commands to execute.
+     * size_t count: number of commands.
+     * SDL_Color clear_color: background color.
+     */
+    void render(const RenderCommand* commands, size_t count, SDL_Color clear_color);
+
+    /**
+     * Get the framebuffer pixels in ARGB8888.
+     */
+    const uint32_t* pixels() const;
+
+    /**
+     * Get the length of a framebuffer row in bytes.
+     */
+    int pitch() const;
+
+    /**
+     * Get the width of the framebuffer.
+     */
+    int width() const;
+
+    /**
+     * Get the height of the framebuffer.
+     */
+    int height() const;
+
+private:
+    /**
+     * Clear and rasterize the rows [y_begin, y_end) of the framebuffer.
+     */
+    void render_band(int y_begin, int y_end, const RenderCommand* commands, size_t count, uint32_t clear_pixel);
+
+    /**
+     * Fill the part of the rect inside the rows [y_begin, y_end).
+     */
+    void fill_rect(const SDL_Rect& rect, SDL_Color color, int y_begin, int y_end);
+
+    /**
+     * Alpha-blend the source rect of the surface (all of it when empty) scaled to the dest rect, only the part inside
+     * the rows [y_begin, y_end).
+     */
+    void blit_surface(SDL_Surface* surface, const SDL_Rect& source, const SDL_Rect& dest, int y_begin, int y_end);
+};
+
+#endif // !SOFTWARE_RASTERIZER_H
@@ -0,0 +1,79 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <cstddef>
+#include <atomic>
+
+/**
+ * Bounded lock-free queue between exactly one producer thread and one consumer thread.
+ *
+ * A fixed ring of Capacity slots (a power of two) indexed by two ever increasing counters. The producer only
+ * writes m_tail, the consumer only m_head, each reads the other's with acquire ordering, so neither side ever
+ * waits or takes a lock. The counters live on separate cache lines, the two threads do not bounce a line on every
+ * operation.
+ *
+ * T m_items[]: the ring.
+ * std::atomic<size_t> m_head: index of the next item to pop, written by the consumer.
+ * std::atomic<size_t> m_tail: index of the next free slot, written by the producer.
+ *
+ * Public Methods:
+ *  - bool push(): append an item, producer only.
+ *  - bool peek(): copy the oldest item without removing it, consumer only.
+ *  - void pop(): remove the oldest item, consumer only.
+ *
+ */
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    T m_items[Capacity] = {};
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+
+public:
+    /**
+     * Append an item. Producer thread only.
+     *
+     * Returns:
+     * bool: false if the queue is full, the item is not added then.
+     */
+    bool push(const T& item)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+        m_items[tail & (Capacity - 1)] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Copy the oldest item without removing it. Consumer thread only.
+     *
+     * Returns:
+     * bool: false if the queue is empty.
+     */
+    bool peek(T& item) const
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        item = m_items[head & (Capacity - 1)];
+        return true;
+    }
+
+    /**
+     * Remove the oldest item, MUST follow a successful peek(). Consumer thread only.
+     */
+    void pop()
+    {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+};
+
+#endif // !SPSC_QUEUE_H
@@ -0,0 +1,61 @@
+#ifndef STATIC_LAYOUT_H
+#define STATIC_LAYOUT_H
+
+#include <span>
+#include <memory_resource>
+#include <vector>
+
+#include "SDL.h"
+
+#include "Brick.h"
+#include "BricksLayout.h"
+
+/**
+ * Plain description of a brick that can be computed at compile time, Brick itself is built at runtime.
+ *
+ * int x, y: top left corner.
+ * int width, height: size of the brick.
+ * int points: points player earns by hitting the brick.
+ * SDL_Color color: color of the brick.
+ */
+struct BrickData
+{
+    int x;
+    int y;
+    int width;
+    int height;
+    int points;
+    SDL_Color color;
+};
+
+/**
+ * StaticLayout class is a concrete implementation of the BricksLayout interface. Lays out bricks described by a
+ * fixed table, typically a constexpr std::array baked into the binary by a compile time layout like
+ * make_row_bricks(), so a built in level computes nothing at startup and only copies its bricks.
+ * The table is not copied, it must outlive the layout.
+ *
+ * Public Methods:
+ * - StaticLayout(): constructor that takes the table of bricks.
+ * - std::pmr::vector<Brick> create_bricks(std::pmr::memory_resource*): creates the bricks of the table.
+ *
+ */
+class StaticLayout : public BricksLayout
+{
+    const std::span<const BrickData> m_bricks;
+
+public:
+    StaticLayout(std::span<const BrickData> bricks);
+
+    /**
+     * Create the bricks of the table, in its order.
+     *
+     * Params:
+     * std::pmr::memory_resource* arena: memory of the returned vector.
+     *
+     * Returns:
+     * std::pmr::vector<Brick>: vector of bricks.
+     */
+    std::pmr::vector<Brick> create_bricks(std::pmr::memory_resource* arena);
+};
+
+#endif // !STATIC_LAYOUT_H
@@ -0,0 +1,62 @@
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include <string_view>
+#include <memory_resource>
+#include <vector>
+
+#include "Brick.h"
+#include "BricksLayout.h"
+#include "TextLevel.h"
+
+/**
+ * BricksLayout parsed from a text level, see parse_text_level() for the format.
+ * Meant for editing levels, shipped levels are compiled ahead of time by levelc into the binary format that
+ * BinaryLevelLayout loads without any parsing.
+ *
+ * TextLevel m_level: the parsed level.
+ *
+ * Public Methods:
+ *  - std::pmr::vector<Brick> create_bricks(std::pmr::memory_resource*): the bricks of the level.
+ *  - int get_width(), get_height(): size of the playfield the level was made for.
+ *
+ */
+class TextLayout : public BricksLayout
+{
+    TextLevel m_level;
+
+public:
+    /**
+     * Constructor for the TextLayout class. Parses the level.
+     *
+     * Params:
+     * const std::string_view path: path of the text level. MUST be zero terminated.
+     *
+     * Throws:
+     * std::runtime_error: if the file could not be read or is not a valid level.
+     */
+    TextLayout(const std::string_view path);
+
+    /**
+     * Create the bricks of the level, row by row.
+     *
+     * Params:
+     * std::pmr::memory_resource* arena: memory of the returned vector.
+     *
+     * Returns:
+     * std::pmr::vector<Brick>: vector of bricks.
+     */
+    std::pmr::vector<Brick> create_bricks(std::pmr::memory_resource* arena);
+
+    /**
+     * Get the width of the playfield the level was made for.
+     */
+    int get_width() const;
+
+    /**
+     * Get the height of the playfield the level was made for.
+     */
+    int get_height() const;
+};
+
+#endif // !TEXT_LAYOUT_H
@@ -0,0 +1,53 @@
+#ifndef TEXT_LEVEL_H
+#define TEXT_LEVEL_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "SDL.h"
+
+#include "LevelFile.h"
+
+/**
+ * A level parsed from its text form, in the records of the binary format (see LevelFile.h).
+ *
+ * uint32_t width, height: size of the playfield the level was made for.
+ * std::vector<SDL_Color> palette: colors of the legend, in the order of the legend.
+ * std::vector<LevelFileBrick> bricks: the bricks, row by row from the top, left to right.
+ */
+struct TextLevel
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<SDL_Color> palette;
+    std::vector<LevelFileBrick> bricks;
+};
+
+/**
+ * Parse a text level. The format is line based, '#' starts a comment outside of the grid:
+ *
+ *      size 800 600            # playfield the level is made for, required
+ *      cell 80 30 10           # width and height of a grid cell, spacing between the bricks (optional, 0)
+ *      offset 0 60             # top left corner of the grid, optional
+ *      legend R ff0000 7       # a brick character, its color as RRGGBB or RRGGBBAA and its points
+ *      legend G 00ff00 5
+ *      grid                    # every following line is a row of cells, '.' and ' ' are empty
+ *      RRRRRRRRRR
+ *      GG..GG..GG
+ *
+ * A brick fills its cell less the spacing, like RowLayout. The file is read in a single pass with a fixed line
+ * buffer, nothing is allocated but the palette and the bricks themselves. Every brick must fit the playfield.
+ *
+ * Params:
+ * const std::string_view path: path of the text level. MUST be zero terminated.
+ *
+ * Returns:
+ * TextLevel: the parsed level.
+ *
+ * Throws:
+ * std::runtime_error: if the file could not be read or is not a valid level, the reason and line are logged.
+ */
+TextLevel parse_text_level(const std::string_view path);
+
+#endif // !TEXT_LEVEL_H
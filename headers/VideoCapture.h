@@ -0,0 +1,126 @@
+#ifndef VIDEO_CAPTURE_H
+#define VIDEO_CAPTURE_H
+
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <string_view>
+
+#include "Screen.h"
+#include "Y4MWriter.h"
+
+/**
+ * Asynchronous capture of the presented frames into a raw Y4M video.
+ *
+ * The game thread reads every rendered frame back from the Screen into the next free buffer of a preallocated ring
+ * and moves on. A worker thread converts the buffered frames to YUV and streams them to disk. The game thread never
+ * waits for the disk: when the ring is full the frame is dropped and counted instead.
+ * The ring is single producer (game thread), single consumer (worker). The slot states are atomics, the mutex and
+ * condition variable are only used to put the idle worker to sleep.
+ *
+ * Y4MWriter m_writer: output file.
+ * int m_width, m_height: size of the captured frames.
+ * int m_slot_count: number of frame buffers in the ring.
+ * std::unique_ptr<Slot[]> m_slots: the ring of frame buffers.
+ * std::unique_ptr<uint8_t[]> m_yuv: conversion buffer of the worker.
+ * uint64_t m_write_index: next slot the game thread fills. Only touched by the game thread.
+ * uint64_t m_read_index: next slot the worker writes out. Only touched by the worker.
+ * std::atomic<uint64_t> m_captured, m_dropped, m_written: frame counters.
+ *
+ * Public Methods:
+ *  - VideoCapture(): open the file, allocate the ring and start the worker.
+ *  - bool capture(): read the rendered frame of the screen into the ring.
+ *  - uint64_t get_captured(), get_dropped(), get_written(): frame counters.
+ *
+ */
+class VideoCapture
+{
+    /**
+     * One buffer of the ring. filled is false when the slot is free (owned by the game thread), true when it waits for the worker.
+     */
+    struct Slot
+    {
+        std::unique_ptr<uint32_t[]> pixels;
+        std::atomic<bool> filled{false};
+    };
+
+    Y4MWriter m_writer;
+    int m_width;
+    int m_height;
+    int m_slot_count;
+    std::unique_ptr<Slot[]> m_slots;
+    std::unique_ptr<uint8_t[]> m_yuv;
+    uint64_t m_write_index = 0;
+    uint64_t m_read_index = 0;
+
+    std::atomic<uint64_t> m_captured{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<uint64_t> m_written{0};
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake_cv;
+    std::atomic<bool> m_stop{false};
+    std::thread m_worker;
+
+public:
+    VideoCapture(const VideoCapture&) = delete;
+    VideoCapture& operator=(const VideoCapture&) = delete;
+
+    /**
+     * Constructor for the VideoCapture class. Opens the file, allocates the ring and starts the worker.
+     *
+     * Params:
+     * const std::string_view path: path of the .y4m file. MUST be zero terminated.
+     * int width: width of the captured frames.
+     * int height: height of the captured frames.
+     * int fps: frame rate written into the video header.
+     * int ring_size: number of frames that can wait for the disk before new ones are dropped.
+     *
+     * Throws:
+     * std::runtime_error: if the file could not be opened.
+     */
+    VideoCapture(const std::string_view path, int width, int height, int fps, int ring_size = 8);
+
+    /**
+     * Writes out the frames still in the ring, stops the worker and logs the counters.
+     */
+    ~VideoCapture();
+
+    /**
+     * Read the frame rendered by the screen into the ring. Call between Screen::render() and Screen::present().
+     * Never blocks on the disk.
+     *
+     * Params:
+     * Screen& screen: screen with a rendered frame and readback enabled.
+     *
+     * Returns:
+     * bool: false if the frame was dropped because the ring is full or could not be read.
+     */
+    bool capture(Screen& screen);
+
+    /**
+     * Get the number of frames put into the ring.
+     */
+    uint64_t get_captured() const;
+
+    /**
+     * Get the number of frames dropped because the ring was full.
+     */
+    uint64_t get_dropped() const;
+
+    /**
+     * Get the number of frames written to disk.
+     */
+    uint64_t get_written() const;
+
+private:
+    /**
+     * Body of the worker thread. Converts and writes the filled slots in order.
+     */
+    void worker_main();
+};
+
+#endif // !VIDEO_CAPTURE_H
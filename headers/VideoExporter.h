@@ -0,0 +1,116 @@
+#ifndef VIDEO_EXPORTER_H
+#define VIDEO_EXPORTER_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <string_view>
+
+#include "Screen.h"
+#include "WorkerPool.h"
+#include "Y4MWriter.h"
+
+/**
+ * Lossless offline export of rendered frames into a raw Y4M video, as fast as the CPU allows.
+ *
+ * Unlike VideoCapture no frame is ever dropped, the game waits for the encoder instead. Frames are collected into
+ * batches. A full batch is converted to YUV in parallel on a WorkerPool, one frame per task, and handed to a writer
+ * thread while the game fills the other batch. The frames reach the file in the order they were exported.
+ *
+ * Y4MWriter m_writer: output file.
+ * int m_width, m_height: size of the frames.
+ * WorkerPool m_pool: threads converting the frames.
+ * int m_batch_size: number of frames in a batch.
+ * Batch m_batches[2]: the batch being filled and the batch being written.
+ * int m_filling: index of the batch being filled.
+ * int m_pending: index of the batch waiting for the writer, -1 if none.
+ * uint64_t m_frames: number of exported frames.
+ *
+ * Public Methods:
+ *  - bool export_frame(): read the rendered frame of the screen and queue it for encoding.
+ *  - uint64_t get_frames(): number of exported frames.
+ *
+ */
+class VideoExporter
+{
+    /**
+     * Frames of a batch, as read back and as converted.
+     */
+    struct Batch
+    {
+        std::unique_ptr<uint32_t[]> pixels;
+        std::unique_ptr<uint8_t[]> yuv;
+        int count = 0;
+    };
+
+    Y4MWriter m_writer;
+    int m_width;
+    int m_height;
+    WorkerPool m_pool;
+    int m_batch_size;
+    Batch m_batches[2];
+    int m_filling = 0;
+    int m_pending = -1;
+    uint64_t m_frames = 0;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+    std::thread m_writer_thread;
+
+public:
+    VideoExporter(const VideoExporter&) = delete;
+    VideoExporter& operator=(const VideoExporter&) = delete;
+
+    /**
+     * Constructor for the VideoExporter class. Opens the file and starts the conversion and writer threads.
+     *
+     * Params:
+     * const std::string_view path: path of the .y4m file. MUST be zero terminated.
+     * int width: width of the frames.
+     * int height: height of the frames.
+     * int fps: frame rate written into the video header.
+     * int threads: number of threads converting the frames.
+     *
+     * Throws:
+     * std::runtime_error: if the file could not be opened.
+     */
+    VideoExporter(const std::string_view path, int width, int height, int fps, int threads);
+
+    /**
+     * Encodes the remaining frames and stops the threads.
+     */
+    ~VideoExporter();
+
+    /**
+     * Read the frame rendered by the screen and queue it for encoding. Call between Screen::render() and Screen::present().
+     * Blocks if the encoder is behind by more than a batch.
+     *
+     * Params:
+     * Screen& screen: screen with a rendered frame and readback enabled.
+     *
+     * Returns:
+     * bool: false if the frame could not be read back.
+     */
+    bool export_frame(Screen& screen);
+
+    /**
+     * Get the number of exported frames.
+     */
+    uint64_t get_frames() const;
+
+private:
+    /**
+     * Convert the batch being filled in parallel and hand it to the writer thread.
+     */
+    void flush_batch();
+
+    /**
+     * Body of the writer thread.
+     */
+    void writer_main();
+};
+
+#endif // !VIDEO_EXPORTER_H
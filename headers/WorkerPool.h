@@ -0,0 +1,108 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
+
+/**
+ * Fixed set of worker threads executing indexed tasks in parallel (fork-join).
+ *
+ * run() hands out the task indices [0, task_count) to the workers and to the calling thread and returns once all
+ * of them are done. The task is passed as a plain function pointer with a context, so dispatching does not allocate.
+ * A pool of size 1 has no worker threads and runs everything on the calling thread.
+ *
+ * std::vector<std::thread> m_threads: worker threads. One less than the pool size, the caller works too.
+ * std::mutex m_mutex: guards the job state below.
+ * std::condition_variable m_work_cv: wakes the workers when a job is posted or the pool is stopped.
+ * std::condition_variable m_done_cv: wakes the caller when the last task of a job is finished.
+ *
+ * Public Methods:
+ *  - WorkerPool(): start the worker threads.
+ *  - void run(): run the tasks and wait for them to finish.
+ *  - int size(): number of threads executing tasks including the caller.
+ *
+ */
+class WorkerPool
+{
+    using TaskFn = void (*)(void* context, int index);
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_work_cv;
+    std::condition_variable m_done_cv;
+
+    TaskFn m_task = nullptr;
+    void* m_context = nullptr;
+    int m_task_count = 0;
+    int m_next_task = 0;
+    int m_unfinished = 0;
+    uint64_t m_generation = 0;
+    bool m_stop = false;
+
+public:
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * Constructor for the WorkerPool class.
+     *
+     * Params:
+     * int threads: total number of threads working on a job including the calling thread. Values below 1 mean 1.
+     */
+    WorkerPool(int threads);
+
+    /**
+     * Stops and joins the worker threads.
+     */
+    ~WorkerPool();
+
+    /**
+     * Run task(index) for every index in [0, task_count) across the pool and wait for all of them to finish.
+     * Must not be called concurrently or from inside a task.
+     *
+     * Params:
+     * int task_count: number of tasks.
+     * F&& task: callable taking the task index.
+     */
+    template <typename F>
+    void run(int task_count, F&& task)
+    {
+        run_raw(
+            task_count,
+            [](void* context, int index) { (*static_cast<std::remove_reference_t<F>*>(context))(index); },
+            const_cast<void*>(static_cast<const void*>(&task))
+        );
+    }
+
+    /**
+     * Number of threads executing the tasks including the caller.
+     */
+    int size() const;
+
+    /**
+     * Number of hardware threads, at least 1.
+     */
+    static int hardware_threads();
+
+private:
+    /**
+     * Type erased version of run().
+     */
+    void run_raw(int task_count, TaskFn task, void* context);
+
+    /**
+     * Claim and execute tasks of the current job until none are left. Expects the lock to be held, returns with it held.
+     */
+    void work(std::unique_lock<std::mutex>& lock);
+
+    /**
+     * Body of the worker threads.
+     */
+    void worker_main();
+};
+
+#endif // !WORKER_POOL_H
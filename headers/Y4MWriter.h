@@ -0,0 +1,77 @@
+#ifndef Y4M_WRITER_H
+#define Y4M_WRITER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <string_view>
+
+/**
+ * Writer of raw YUV4MPEG2 (.y4m) video files with 4:2:0 full range (C420jpeg) frames.
+ *
+ * Y4M is uncompressed, so writing is a plain sequential fwrite and any encoder (ffmpeg, x264, ...) can consume it.
+ * The RGB to YUV conversion is a separate static function so it can run on a different thread than the writes.
+ *
+ * std::unique_ptr<std::FILE, decltype(&std::fclose)> m_file: output file.
+ * int m_width: width of the video.
+ * int m_height: height of the video.
+ *
+ * Public Methods:
+ *  - Y4MWriter(): open the file and write the stream header.
+ *  - void write_frame(): write a converted frame.
+ *  - static size_t frame_size(): size of a converted frame in bytes.
+ *  - static void convert(): convert ARGB8888 pixels to a 4:2:0 frame.
+ *
+ */
+class Y4MWriter
+{
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> m_file{nullptr, std::fclose};
+    int m_width;
+    int m_height;
+
+public:
+    /**
+     * Constructor for the Y4MWriter class. Opens the file and writes the stream header.
+     *
+     * Params:
+     * const std::string_view path: path of the output file. MUST be zero terminated.
+     * int width: width of the video.
+     * int height: height of the video.
+     * int fps: frames per second of the video.
+     *
+     * Throws:
+     * std::runtime_error: if the file could not be opened.
+     */
+    Y4MWriter(const std::string_view path, int width, int height, int fps);
+
+    /**
+     * Write one frame converted by convert().
+     *
+     * Params:
+     * const uint8_t* yuv: frame_size() bytes of Y, U and V planes.
+     *
+     * Returns:
+     * bool: false if the write failed.
+     */
+    bool write_frame(const uint8_t* yuv);
+
+    /**
+     * Size of one converted frame in bytes (Y plane + two quarter size chroma planes).
+     */
+    static size_t frame_size(int width, int height);
+
+    /**
+     * Convert ARGB8888 pixels to planar 4:2:0 YUV, BT.601 full range. Chroma is averaged over 2x2 blocks.
+     *
+     * Params:
+     * const uint32_t* pixels: source pixels.
+     * int pitch: length of a source row in bytes.
+     * int width: width of the frame.
+     * int height: height of the frame.
+     * uint8_t* yuv: destination of frame_size() bytes.
+     */
+    static void convert(const uint32_t* pixels, int pitch, int width, int height, uint8_t* yuv);
+};
+
+#endif // !Y4M_WRITER_H
@@ -1,44 +1,137 @@
 #include <iostream>
 #include <vector>
+#include <memory>
+#include <utility>
 
 #include "SDL.h"    // expecting SDL to be installed on the sysmte, -I/path/.../SDL2 during compilation, CMAKE should take care of this
 
 #include "ArkanoidGame.h"
 #include "RowLayout.h"
+#include "StaticLayout.h"
+#include "ProceduralLayout.h"
+#include "RecordedLayout.h"
+#include "LevelPack.h"
+#include "InputLog.h"
+#include "RunOptions.h"
+#include "AllocationCounter.h"
 
-
-int main(int argc, char* args[])
+namespace
 {
-    GameSettings settings = GameSettings{
-        /* .screen_width = */ 800,
-        /* .screen_height = */ 600,
-        /* .paddle_width = */ 100,
-        /* .paddle_height = */ 10,
-        /* .paddle_speed = */ 6,
-        /* .paddle_offset = */ 80,
-        /* .ball_size = */ 10,
-        /* .ball_speed = */ 4,
-        /* .num_of_balls = */ 3,
-        /* .fps_limit = */ 60
+    // The default rows of the game, laid out at compile time and baked into the binary
+    constexpr RowLayoutSettings classic_settings{
+        /*.starting_row = */ 2,
+        /*.brick_rows = */ 4,
+        /*.brick_cols = */ 10,
+        /*.brick_spacing = */ 10,
+        /*.brick_width = */ 800 / 10,
+        /*.brick_height = */ 30
     };
+    constexpr auto classic_bricks = make_row_bricks<classic_settings>();
+}
 
-    RowLayout layout = RowLayout(
-        RowLayoutSettings{
-            /*.starting_row = */ 2,
-            /*.brick_rows = */ 4,
-            /*.brick_cols = */ 10,
-            /*.brick_spacing = */ 10,
-            /*.brick_width = */ 800 / 10,
-            /*.brick_height = */ 30
-        }
-    );
 
+int main(int argc, char* args[])
+{
+    // SDL must allocate through the counter from its very first allocation on
+    install_allocation_counter();
     try
     {
+        RunOptions options = parse_run_options(argc, args);
+
+        // A replay rebuilds the recorded game, its settings, bricks and seed come from the log
+        std::unique_ptr<InputPlayback> playback;
+        if (!options.replay_input_path.empty())
+        {
+            playback = std::make_unique<InputPlayback>(options.replay_input_path);
+            options.seed = playback->get_seed();
+        }
+        // A level brings the bricks and the size of the playfield, compiled levels skip the parsing.
+        // A pack starts with its first level, the game prefetches the others while playing.
+        std::unique_ptr<LevelPack> level_pack;
+        LoadedLevel level{};
+        if (!playback && !options.level_pack_path.empty())
+        {
+            level_pack = std::make_unique<LevelPack>(options.level_pack_path);
+            level = load_level(level_pack->get_path(0));
+        }
+        else if (!playback && !options.level_path.empty())
+        {
+            level = load_level(options.level_path);
+        }
+        // The playfield takes the size the level was made for, the window shows as much of it as --window allows
+        const int playfield_width = level.layout ? level.width : options.window_width;
+        const int playfield_height = level.layout ? level.height : options.window_height;
+
+        GameSettings settings = playback ? playback->get_settings() : GameSettings{
+            /* .screen_width = */ playfield_width,
+            /* .screen_height = */ playfield_height,
+            /* .paddle_width = */ 100,
+            /* .paddle_height = */ 10,
+            /* .paddle_speed = */ 6,
+            /* .paddle_offset = */ 80,
+            /* .ball_size = */ 10,
+            /* .ball_speed = */ 4,
+            /* .num_of_balls = */ 3,
+            /* .fps_limit = */ 60
+        };
+
+        RowLayout row_layout = RowLayout(
+            RowLayoutSettings{
+                /*.starting_row = */ 2,
+                /*.brick_rows = */ options.layout_rows,
+                /*.brick_cols = */ options.layout_cols,
+                /*.brick_spacing = */ 10,
+                /*.brick_width = */ options.window_width / options.layout_cols,
+                /*.brick_height = */ 30
+            }
+        );
+
+        StaticLayout classic_layout = StaticLayout(classic_bricks);
+        const bool classic = options.layout_rows == classic_settings.brick_rows
+            && options.layout_cols == classic_settings.brick_cols
+            && options.window_width / options.layout_cols == classic_settings.brick_width;
+
+        ProceduralLayout procedural_layout = ProceduralLayout(
+            ProceduralLayoutSettings{
+                /*.seed = */ options.procedural_seed,
+                /*.starting_row = */ 2,
+                /*.brick_rows = */ options.layout_rows,
+                /*.brick_cols = */ options.layout_cols,
+                /*.brick_spacing = */ 10,
+                /*.brick_width = */ options.window_width / options.layout_cols,
+                /*.brick_height = */ 30,
+                /*.density = */ options.procedural_density
+            }
+        );
+
+        RecordedLayout recorded_layout = RecordedLayout(playback ? playback->get_bricks() : std::vector<Brick>{});
+        BricksLayout& layout = playback ? static_cast<BricksLayout&>(recorded_layout)
+            : level.layout ? *level.layout
+            : options.procedural ? static_cast<BricksLayout&>(procedural_layout)
+            : classic ? static_cast<BricksLayout&>(classic_layout)
+            : row_layout;
+
         ArkanoidGame arkanoid(
             settings,
-            layout
+            layout,
+            options,
+            std::move(playback),
+            std::move(level_pack)
         );
+        if (options.benchmark)
+        {
+            // Finished games restart right away until the benchmark played all its frames
+            while (!arkanoid.game_loop())
+            {
+            }
+            if (options.alloc_check)
+            {
+                const uint64_t allocating_frames = arkanoid.get_allocating_frames();
+                SDL_Log("Allocation check: %llu frames allocated after the warm-up\n", static_cast<unsigned long long>(allocating_frames));
+                return allocating_frames == 0 ? 0 : 1;
+            }
+            return 0;
+        }
         bool restart = false;
         do
         {
@@ -49,9 +142,10 @@ int main(int argc, char* args[])
             }
         } while (restart);
     }
-    catch(std::runtime_error e)
+    catch(const std::runtime_error& e)
     {
         SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION , "Exiting program because of an exception. See cerr for more info.\n");
+        return 1;
     }
 
     return 0;
@@ -0,0 +1,139 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#include "SDL.h"
+
+#include "AllocationCounter.h"
+
+#ifdef ARKANOID_COUNT_ALLOCATIONS
+
+namespace
+{
+    std::atomic<uint64_t> allocations{0};
+
+    SDL_malloc_func sdl_malloc = nullptr;
+    SDL_calloc_func sdl_calloc = nullptr;
+    SDL_realloc_func sdl_realloc = nullptr;
+    SDL_free_func sdl_free = nullptr;
+
+    void count()
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void* SDLCALL counted_malloc(size_t size)
+    {
+        count();
+        return sdl_malloc(size);
+    }
+
+    void* SDLCALL counted_calloc(size_t count_of, size_t size)
+    {
+        count();
+        return sdl_calloc(count_of, size);
+    }
+
+    void* SDLCALL counted_realloc(void* memory, size_t size)
+    {
+        count();
+        return sdl_realloc(memory, size);
+    }
+
+    void* allocate(std::size_t size)
+    {
+        count();
+        if (void* memory = std::malloc(size ? size : 1))
+        {
+            return memory;
+        }
+        throw std::bad_alloc();
+    }
+
+    void* allocate_aligned(std::size_t size, std::align_val_t alignment)
+    {
+        count();
+        const std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+        void* memory = _aligned_malloc(size ? size : 1, align);
+#else
+        // aligned_alloc wants the size in whole alignments
+        void* memory = std::aligned_alloc(align, ((size ? size : 1) + align - 1) / align * align);
+#endif
+        if (!memory)
+        {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+
+    void free_aligned(void* memory)
+    {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        std::free(memory);
+#endif
+    }
+}
+
+// Every form of the global operator new ends up in allocate(), the nothrow ones by the standard library's defaults
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocate_aligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocate_aligned(size, alignment); }
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { free_aligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { free_aligned(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { free_aligned(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { free_aligned(memory); }
+
+bool allocation_counting_enabled()
+{
+    return true;
+}
+
+void install_allocation_counter()
+{
+    if (sdl_malloc)
+    {
+        return;
+    }
+    SDL_GetMemoryFunctions(&sdl_malloc, &sdl_calloc, &sdl_realloc, &sdl_free);
+    if (SDL_SetMemoryFunctions(counted_malloc, counted_calloc, counted_realloc, sdl_free) != 0)
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Could not count the allocations of SDL! SDL_Error: %s\n", SDL_GetError());
+    }
+}
+
+uint64_t get_allocation_count()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+#else
+
+bool allocation_counting_enabled()
+{
+    return false;
+}
+
+void install_allocation_counter()
+{
+}
+
+uint64_t get_allocation_count()
+{
+    return 0;
+}
+
+#endif
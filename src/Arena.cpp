@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+
+#include "Arena.h"
+
+Arena::Arena(size_t initial_capacity):
+    m_block{initial_capacity > 0 ? new std::byte[initial_capacity] : nullptr},
+    m_capacity{initial_capacity}
+{
+}
+
+void Arena::reset()
+{
+    if (m_overflow_bytes > 0)
+    {
+        // One block for all of the last cycle, at least doubling so a slowly growing arena resizes rarely
+        m_capacity = std::max(m_capacity * 2, m_used + m_overflow_bytes);
+        m_block.reset(new std::byte[m_capacity]);
+    }
+    m_overflow.release();
+    m_used = 0;
+    m_overflow_bytes = 0;
+}
+
+void Arena::reserve(size_t capacity)
+{
+    if (capacity <= m_capacity || used() > 0)
+    {
+        return;
+    }
+    m_capacity = capacity;
+    m_block.reset(new std::byte[m_capacity]);
+}
+
+size_t Arena::used() const
+{
+    return m_used + m_overflow_bytes;
+}
+
+size_t Arena::capacity() const
+{
+    return m_capacity;
+}
+
+void* Arena::do_allocate(size_t bytes, size_t alignment)
+{
+    if (m_block)
+    {
+        const uintptr_t base = reinterpret_cast<uintptr_t>(m_block.get());
+        const size_t offset = static_cast<size_t>(((base + m_used + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base);
+        if (offset <= m_capacity && bytes <= m_capacity - offset)
+        {
+            m_used = offset + bytes;
+            return m_block.get() + offset;
+        }
+    }
+    m_overflow_bytes += bytes + alignment;
+    return m_overflow.allocate(bytes, alignment);
+}
+
+void Arena::do_deallocate(void*, size_t, size_t)
+{
+    // Monotonic, the memory comes back with reset()
+}
+
+bool Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
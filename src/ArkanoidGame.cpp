@@ -1,3 +1,11 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
 #include <vector>
 #include <iostream>
 
@@ -7,27 +15,136 @@
 #include "Screen.h"
 #include "Ball.h"
 #include "Paddle.h"
+#include "Clock.h"
 #include "FrameLimiter.h"
 #include "BricksLayout.h"
 #include "Score.h"
 #include "GameSettings.h"
+#include "RunOptions.h"
+#include "VideoCapture.h"
+#include "VideoExporter.h"
+#include "InputLog.h"
+#include "Gamepad.h"
+#include "FrameStats.h"
+#include "LevelPack.h"
+#include "LevelWatcher.h"
+#include "AllocationCounter.h"
 
 #include "ArkanoidGame.h"
 
 
 ArkanoidGame::ArkanoidGame(
     const GameSettings settings,
-    BricksLayout& bricks_layout
+    BricksLayout& bricks_layout,
+    const RunOptions& options,
+    std::unique_ptr<InputPlayback> input_playback,
+    std::unique_ptr<LevelPack> level_pack
 ):
     m_settings(settings),
-    m_screen("Arkanoid", settings.screen_width, settings.screen_height),
-    m_ball(settings.ball_size, settings.ball_speed, settings.ball_speed, false),
-    m_paddle(settings.screen_width / 2 - settings.paddle_width / 2, settings.screen_height - settings.paddle_offset, settings.paddle_width, settings.paddle_height, settings.paddle_speed),
-    m_bricks(bricks_layout),
+    m_screen(
+        "Arkanoid",
+        std::min(options.window_width, settings.screen_width),
+        std::min(options.window_height, settings.screen_height),
+        options.renderer,
+        options.raster_threads
+    ),
+    m_ball(settings.ball_size, settings.ball_speed, settings.ball_speed, false, settings.fps_limit, settings.physics_hz),
+    m_paddle(settings.screen_width / 2 - settings.paddle_width / 2, settings.screen_height - settings.paddle_offset, settings.paddle_width, settings.paddle_height, settings.paddle_speed, settings.fps_limit, settings.physics_hz),
+    m_bricks(std::make_unique<Bricks>(bricks_layout)),
     m_score("assets/DejaVuSans.ttf", 20, settings.num_of_balls),
-    m_frame_limiter(m_settings.fps_limit)
+    m_clock(options.virtual_time ? std::unique_ptr<Clock>(std::make_unique<VirtualClock>()) : std::make_unique<RealClock>()),
+    m_frame_limiter(*m_clock, m_settings.fps_limit, options.pacing),
+    m_frame_stats(m_settings.fps_limit, options.frame_stats_csv_path),
+    m_input_playback(std::move(input_playback)),
+    m_level_pack(std::move(level_pack)),
+    m_virtual_time(options.virtual_time),
+    m_benchmark_frames(options.benchmark ? options.benchmark_frames : 0),
+    m_benchmark_report_path(options.benchmark_report_path),
+    m_layout_name(
+        !options.level_pack_path.empty() ? options.level_pack_path
+        : !options.level_path.empty() ? options.level_path
+        : std::to_string(options.layout_rows) + "x" + std::to_string(options.layout_cols)
+            + (options.procedural ? " procedural " + std::to_string(options.procedural_seed) : "")
+    ),
+    m_raster_threads(options.raster_threads),
+    m_seed(options.seed),
+    m_rng(options.seed),
+    m_alloc_check(options.alloc_check)
 {
+    // Idling needs real window events and must not skip ticks of a replay or frames of a capture
+    m_idle_rendering = options.idle_rendering
+        && !options.virtual_time
+        && options.renderer != RendererType::Headless
+        && !m_input_playback
+        && options.capture_path.empty();
+
     m_screen.make_resizable();
+    m_screen.set_playfield(settings.screen_width, settings.screen_height);
+    if (!options.record_input_path.empty())
+    {
+        m_input_recorder = std::make_unique<InputRecorder>(
+            options.record_input_path,
+            options.seed,
+            settings,
+            m_bricks->get_bricks(),
+            static_cast<uint64_t>(options.keyframe_interval) * settings.physics_hz
+        );
+    }
+    if (m_input_playback)
+    {
+        SDL_Log("Replaying %zu ticks from %s\n", m_input_playback->get_tick_count(), options.replay_input_path.c_str());
+        // Seeking skips ticks, a log recorded from the replay would miss them
+        m_seek_pending = options.replay_seek > 0 && !m_input_recorder;
+        m_seek_tick = static_cast<uint64_t>(options.replay_seek) * settings.physics_hz;
+    }
+    if (!options.export_path.empty())
+    {
+        m_screen.enable_readback();
+        m_exporter = std::make_unique<VideoExporter>(
+            options.export_path, 
+            m_screen.width(), 
+            m_screen.height(), 
+            settings.fps_limit, 
+            options.export_threads
+        );
+    }
+    if (!options.capture_path.empty())
+    {
+        m_screen.enable_readback();
+        m_capture = std::make_unique<VideoCapture>(
+            options.capture_path, 
+            m_screen.width(), 
+            m_screen.height(), 
+            settings.fps_limit, 
+            options.capture_ring
+        );
+    }
+    if (options.gamepad && !options.virtual_time && !m_input_playback && options.renderer != RendererType::Headless)
+    {
+        m_gamepad = std::make_unique<Gamepad>(1000, options.gamepad_deadzone);
+    }
+    if (m_level_pack)
+    {
+        SDL_Log("Level 1 of %zu: %s\n", m_level_pack->size(), m_level_pack->get_path(0).c_str());
+        m_level_pack->prefetch(1);
+    }
+    if (options.watch_level && !m_input_playback)
+    {
+        m_level_watcher = std::make_unique<LevelWatcher>(m_level_pack ? m_level_pack->get_path(0) : options.level_path);
+    }
+    if (m_benchmark_frames > 0)
+    {
+        m_benchmark_start = m_wall_clock.now();
+    }
+
+    m_physics_task = m_scheduler.add_task("physics", settings.physics_hz, 2 * settings.physics_hz / settings.fps_limit);
+    m_hud_task = m_scheduler.add_task("hud", settings.hud_hz);
+    m_telemetry_task = m_scheduler.add_task("telemetry", settings.telemetry_hz);
+}
+
+ArkanoidGame::~ArkanoidGame()
+{
+    m_scheduler.log_summary();
 }
 
 void ArkanoidGame::poll_for_events()
@@ -39,7 +156,52 @@ void ArkanoidGame::poll_for_events()
         {
             m_hard_quit = true;
         }
+        else if (e.type == SDL_KEYDOWN || e.type == SDL_KEYUP)
+        {
+            queue_key_event(e.key);
+        }
+        else if (m_level_watcher && e.type == m_level_watcher->get_event_type())
+        {
+            reload_level();
+        }
+    }
+}
+
+void ArkanoidGame::queue_key_event(const SDL_KeyboardEvent& key)
+{
+    if (key.repeat)
+    {
+        return;
+    }
+    if (m_input_playback)
+    {
+        // The replay ignores the keyboard, the arrows seek 10 seconds instead
+        const bool left = key.keysym.scancode == SDL_SCANCODE_LEFT;
+        if (key.state == SDL_PRESSED && !m_input_recorder && (left || key.keysym.scancode == SDL_SCANCODE_RIGHT))
+        {
+            const uint64_t position = m_input_playback->get_position();
+            const uint64_t distance = 10 * static_cast<uint64_t>(m_settings.physics_hz);
+            m_seek_tick = left ? (position > distance ? position - distance : 0) : position + distance;
+            m_seek_pending = true;
+        }
+        return;
     }
+    InputBits action = 0;
+    switch (key.keysym.scancode)
+    {
+    case SDL_SCANCODE_LEFT: action = InputAction::Left; break;
+    case SDL_SCANCODE_RIGHT: action = InputAction::Right; break;
+    case SDL_SCANCODE_SPACE: action = InputAction::Launch; break;
+    case SDL_SCANCODE_Q:
+    case SDL_SCANCODE_ESCAPE: action = InputAction::Quit; break;
+    case SDL_SCANCODE_R: action = InputAction::Restart; break;
+    default: return;
+    }
+
+    // The event carries SDL ticks (ms), carry its age over to the game clock
+    const uint64_t now = m_clock->now();
+    const uint64_t age = static_cast<uint64_t>(SDL_GetTicks() - key.timestamp) * 1'000'000;
+    m_input_queue.push(age < now ? now - age : now, action, key.state == SDL_PRESSED);
 }
 
 void ArkanoidGame::restart()
@@ -51,28 +213,151 @@ void ArkanoidGame::restart()
     m_ball.reset_to_paddle(m_paddle);
     m_paddle.reset();
     m_score.reset();
-    m_bricks.reset();
+    if (m_level_pack && m_level_pack->get_current() != 0)
+    {
+        // Prefetched when the previous game ended
+        enter_level(m_level_pack->take(0));
+        m_level_pack->prefetch(1);
+        if (m_level_watcher)
+        {
+            m_level_watcher->watch(m_level_pack->get_path(0));
+        }
+    }
+    else
+    {
+        m_bricks->reset();
+        if (m_level_pack)
+        {
+            // Nothing happens if the second level is still prefetched from the last game
+            m_level_pack->prefetch(1);
+        }
+    }
 }
 
 
-void ArkanoidGame::player_input(bool end_screen)
+void ArkanoidGame::present()
 {
-    const Uint8* keyState = SDL_GetKeyboardState(nullptr);      // left or right arrows for movement
+    if (m_capture)
+    {
+        m_screen.render();
+        m_capture->capture(m_screen);
+    }
+    if (m_exporter)
+    {
+        m_screen.render();
+        m_exporter->export_frame(m_screen);
+    }
+    m_screen.present();
+}
+
+InputBits ArkanoidGame::read_input(uint64_t tick_time)
+{
+    InputBits input = 0;
+    if (m_benchmark_frames > 0)
+    {
+        input = scripted_input();
+    }
+    else if (m_input_playback)
+    {
+        if (!m_input_playback->next(input))
+        {
+            input = InputAction::Quit;      // end of the replayed session
+        }
+    }
+    else
+    {
+        input = m_input_queue.consume(tick_time);
+        if (m_gamepad)
+        {
+            // The keyboard moves at full speed, the analog speed only applies to the stick alone
+            const InputBits pad = m_gamepad->consume(tick_time);
+            input |= (input & (InputAction::Left | InputAction::Right)) ? pad & ~InputAction::Speed : pad;
+        }
+    }
+
+    if (m_input_recorder)
+    {
+        m_input_recorder->record(input);
+    }
+    m_last_input = input;
+    return input;
+}
+
+void ArkanoidGame::wait_for_activity()
+{
+    // No physics step consumes the gamepad samples during the wait
+    if (m_gamepad)
+    {
+        m_gamepad->pause();
+    }
+    SDL_Event e;
+    bool active = false;
+    while (!active)
+    {
+        if (SDL_WaitEventTimeout(&e, 1000) == 0)
+        {
+            continue;   // timed out or error, nothing to redraw
+        }
+        switch (e.type)
+        {
+        case SDL_QUIT:
+            m_hard_quit = true;
+            active = true;
+            break;
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+            queue_key_event(e.key);
+            active = true;
+            break;
+        case SDL_CONTROLLERAXISMOTION:
+        case SDL_CONTROLLERBUTTONDOWN:
+        case SDL_CONTROLLERBUTTONUP:
+            active = true;      // the Gamepad thread has the state already
+            break;
+        case SDL_WINDOWEVENT:
+            active = e.window.event == SDL_WINDOWEVENT_EXPOSED
+                || e.window.event == SDL_WINDOWEVENT_SHOWN
+                || e.window.event == SDL_WINDOWEVENT_RESTORED
+                || e.window.event == SDL_WINDOWEVENT_RESIZED
+                || e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED;
+            break;
+        default:
+            if (m_level_watcher && e.type == m_level_watcher->get_event_type())
+            {
+                reload_level();
+                active = true;
+            }
+            break;
+        }
+    }
+    if (m_gamepad)
+    {
+        m_gamepad->resume(m_clock->now());
+    }
+}
+
+void ArkanoidGame::player_input(uint64_t tick_time, bool end_screen)
+{
+    const InputBits input = read_input(tick_time);      // left or right arrows for movement
     if (!end_screen)
     {
-        if (keyState[SDL_SCANCODE_LEFT] && m_paddle.left() > m_screen.left()) 
+        const int speed = (input & InputAction::Speed) >> InputAction::speed_shift;     // analog stick, 0 for full
+        if ((input & InputAction::Left) && m_paddle.left() > m_screen.left()) 
         {
-            m_paddle.move_left(0);
+            m_paddle.move_left(0, speed ? speed : Paddle::full_speed);
         }
-        if (keyState[SDL_SCANCODE_RIGHT] && m_paddle.right() < m_screen.right()) 
+        if ((input & InputAction::Right) && m_paddle.right() < m_screen.right()) 
         {
-            m_paddle.move_right(m_screen.width());
+            m_paddle.move_right(m_screen.right(), speed ? speed : Paddle::full_speed);
         }
-        if (keyState[SDL_SCANCODE_SPACE] && !m_ball.is_moving())        // space to launch the ball if it is not moving
+        if ((input & InputAction::Launch) && !m_ball.is_moving())        // space to launch the ball if it is not moving
         {
+            // Random horizontal direction, reproduced by a replay through the recorded seed
+            m_ball.set_velocity_x(m_rng() & 1 ? m_settings.ball_speed : -m_settings.ball_speed);
+            m_rng_draws++;
             m_ball.set_moving(true);
         }
-        if (keyState[SDL_SCANCODE_Q] || keyState[SDL_SCANCODE_ESCAPE])  // Q or ESC to quit the game
+        if (input & InputAction::Quit)  // Q or ESC to quit the game
         {
             m_hard_quit = true;
             m_running = false;
@@ -81,65 +366,365 @@ void ArkanoidGame::player_input(bool end_screen)
 
     if (end_screen)
     {
-        if (keyState[SDL_SCANCODE_R])  // R to restart the game
+        if (input & InputAction::Restart)  // R to restart the game
         {
             m_restart = true;
             m_running = false;
         }
-        if (keyState[SDL_SCANCODE_Q] || keyState[SDL_SCANCODE_ESCAPE]) 
+        if (input & InputAction::Quit) 
         {
             m_running = false;
         }
     }
 }
 
+void ArkanoidGame::record_frame_times(const FrameTimes& times)
+{
+    if (m_last_frame_start != 0)
+    {
+        m_frame_stats.record(FrameChannel::Frame, times.start - m_last_frame_start);
+    }
+    m_last_frame_start = times.start;
+    m_frame_stats.record(FrameChannel::Poll, times.polled - times.start);
+    m_frame_stats.record(FrameChannel::Input, times.input_ns);
+    m_frame_stats.record(FrameChannel::Sim, times.simulated - times.polled - times.input_ns);
+    m_frame_stats.record(FrameChannel::Render, (times.drawn - times.simulated) + (times.rendered - times.hud));
+    m_frame_stats.record(FrameChannel::Hud, times.hud - times.drawn);
+    m_frame_stats.record(FrameChannel::Present, times.presented - times.rendered);
+    // The input was sampled right after the polling, the frame shows no earlier than the deadline it is paced to.
+    // A virtual clock's deadlines have nothing to do with the wall clock, those frames show when presented.
+    if (!m_virtual_time)
+    {
+        m_frame_stats.record(FrameChannel::Latency, std::max(times.presented, m_frame_limiter.get_present_deadline()) - times.polled);
+    }
+    else
+    {
+        m_frame_stats.record(FrameChannel::Latency, times.presented - times.polled);
+    }
+    m_frame_stats.end_frame(times.presented);
+}
+
+InputBits ArkanoidGame::scripted_input() const
+{
+    if (!m_ball.is_moving())
+    {
+        return InputAction::Launch;
+    }
+    // Keep the center of the paddle under the ball
+    const SDL_Rect* ball = m_ball.get();
+    const int ball_center = ball->x + ball->w / 2;
+    const int paddle_center = m_paddle.left() + m_paddle.width() / 2;
+    if (ball_center < paddle_center - m_settings.paddle_speed)
+    {
+        return InputAction::Left;
+    }
+    if (ball_center > paddle_center + m_settings.paddle_speed)
+    {
+        return InputAction::Right;
+    }
+    return 0;
+}
+
+void ArkanoidGame::write_benchmark_report() const
+{
+    const uint64_t elapsed = m_wall_clock.now() - m_benchmark_start;
+    const double seconds = static_cast<double>(elapsed) / 1e9;
+    const double fps = seconds > 0 ? static_cast<double>(m_frames) / seconds : 0.0;
+    SDL_Log("Benchmark: %llu frames in %.3f s, %.1f fps\n", static_cast<unsigned long long>(m_frames), seconds, fps);
+
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file(std::fopen(m_benchmark_report_path.c_str(), "w"), std::fclose);
+    if (!file)
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Could not open %s for writing\n", m_benchmark_report_path.c_str());
+        return;
+    }
+    std::fprintf(
+        file.get(),
+        "{\n  \"renderer\": \"%s\",\n  \"raster_threads\": %d,\n  \"width\": %d,\n  \"height\": %d,\n"
+        "  \"layout\": \"%s\",\n  \"frames\": %llu,\n  \"seconds\": %.6f,\n  \"fps\": %.3f,\n  \"phases\": ",
+        renderer_name(m_screen.get_renderer_type()),
+        m_raster_threads,
+        m_settings.screen_width,
+        m_settings.screen_height,
+        m_layout_name.c_str(),
+        static_cast<unsigned long long>(m_frames),
+        seconds,
+        fps
+    );
+    m_frame_stats.write_json(file.get());
+    std::fprintf(file.get(), "\n}\n");
+    SDL_Log("Benchmark report written to %s\n", m_benchmark_report_path.c_str());
+}
+
+void ArkanoidGame::step_physics()
+{
+    if (m_ball.is_moving())
+    {
+        if (m_ball.interact(m_screen, m_paddle, *m_bricks, m_score))
+        {
+            m_hud_dirty = true;
+        }
+    }
+    else
+    {
+        m_ball.reset_to_paddle(m_paddle);
+    }
+
+    if (m_bricks->get_brick_count() == 0 && m_score.get_balls_remaining() >= 0
+        && m_level_pack && m_level_pack->get_current() + 1 < m_level_pack->size())
+    {
+        next_level();
+    }
+    else if (m_score.get_balls_remaining() < 0 || m_bricks->get_brick_count() == 0)
+    {
+        m_running = false;
+        if (m_level_pack && m_level_pack->get_current() != 0)
+        {
+            // A restart begins at the first level again. On the first level the bricks are reset instead and the
+            // prefetch of the second level is kept
+            m_level_pack->prefetch(0);
+        }
+    }
+}
+
+void ArkanoidGame::next_level()
+{
+    const size_t next = m_level_pack->get_current() + 1;
+    enter_level(m_level_pack->take(next));
+    m_level_pack->prefetch(next + 1);
+    m_hud_dirty = true;
+    if (m_level_watcher)
+    {
+        m_level_watcher->watch(m_level_pack->get_path(next));
+    }
+    SDL_Log("Level %zu of %zu: %s\n", next + 1, m_level_pack->size(), m_level_pack->get_path(next).c_str());
+}
+
+void ArkanoidGame::enter_level(LevelBricks level)
+{
+    m_bricks = std::move(level.bricks);
+    m_screen.set_playfield(level.width, level.height);
+    m_paddle.set_origin(m_screen.right() / 2 - m_settings.paddle_width / 2, m_screen.bottom() - m_settings.paddle_offset);
+    m_ball.reset_to_paddle(m_paddle);
+}
+
+void ArkanoidGame::reload_level()
+{
+    LevelBricks level = m_level_watcher->take();
+    if (!level.bricks)
+    {
+        return;
+    }
+    // set_playfield() keeps the playfield at least the size of the window
+    if (std::max(level.width, m_screen.width()) == m_screen.right()
+        && std::max(level.height, m_screen.height()) == m_screen.bottom())
+    {
+        m_bricks = std::move(level.bricks);
+    }
+    else
+    {
+        // The ball and paddle may be outside of the resized playfield, start them over at its bottom
+        SDL_Log("Level resized to %dx%d\n", level.width, level.height);
+        enter_level(std::move(level));
+    }
+}
+
+void ArkanoidGame::save_state(std::vector<uint8_t>& state) const
+{
+    const Ball::State ball = m_ball.get_state();
+    const Paddle::State paddle = m_paddle.get_state();
+    const int32_t values[] = {
+        ball.x, ball.y, ball.velocity_x, ball.velocity_y, ball.remainder_x, ball.remainder_y, ball.is_moving,
+        paddle.x, paddle.y, paddle.step_remainder,
+        m_score.m_points, m_score.m_balls_remaining, m_bricks->get_brick_count()
+    };
+    const size_t brick_count = m_bricks->size();
+    state.assign(sizeof(values) + sizeof(m_rng_draws) + (brick_count + 7) / 8, 0);
+    std::memcpy(state.data(), values, sizeof(values));
+    std::memcpy(state.data() + sizeof(values), &m_rng_draws, sizeof(m_rng_draws));
+
+    // A bit per brick, set when the brick is still standing
+    m_bricks->get_visibility(state.data() + sizeof(values) + sizeof(m_rng_draws));
+}
+
+bool ArkanoidGame::load_state(const std::vector<uint8_t>& state)
+{
+    int32_t values[13];
+    uint64_t rng_draws = 0;
+    const size_t brick_count = m_bricks->size();
+    if (state.size() != sizeof(values) + sizeof(rng_draws) + (brick_count + 7) / 8)
+    {
+        return false;
+    }
+    std::memcpy(values, state.data(), sizeof(values));
+    std::memcpy(&rng_draws, state.data() + sizeof(values), sizeof(rng_draws));
+
+    m_ball.set_state(Ball::State{values[0], values[1], values[2], values[3], values[4], values[5], values[6] != 0});
+    m_paddle.set_state(Paddle::State{values[7], values[8], values[9]});
+    m_score.m_points = values[10];
+    m_score.m_balls_remaining = values[11];
+    m_bricks->set_brick_count(values[12]);
+    m_bricks->set_visibility(state.data() + sizeof(values) + sizeof(rng_draws));
+
+    // The generator is rebuilt from the seed, the game draws from it only on a launch
+    m_rng.seed(m_seed);
+    m_rng.discard(rng_draws);
+    m_rng_draws = rng_draws;
+    return true;
+}
+
+void ArkanoidGame::seek_replay()
+{
+    m_seek_pending = false;
+    const uint64_t start = m_wall_clock.now();
+    const InputPlayback::Keyframe* keyframe = m_input_playback->find_keyframe(m_seek_tick);
+    if (!keyframe || !load_state(keyframe->state))
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "No keyframe to seek to tick %llu from\n", static_cast<unsigned long long>(m_seek_tick));
+        return;
+    }
+    m_input_playback->seek(keyframe->tick);
+    while (m_input_playback->get_position() < m_seek_tick && m_running && !m_hard_quit)
+    {
+        player_input(0);
+        step_physics();
+    }
+    m_hud_dirty = true;
+    m_last_frame_start = 0;     // the seek is not a slow frame
+    SDL_Log(
+        "Seeked to tick %llu in %.3f ms, simulated %llu ticks from the keyframe at %llu\n",
+        static_cast<unsigned long long>(m_input_playback->get_position()),
+        static_cast<double>(m_wall_clock.now() - start) / 1e6,
+        static_cast<unsigned long long>(m_input_playback->get_position() - keyframe->tick),
+        static_cast<unsigned long long>(keyframe->tick)
+    );
+}
+
+void ArkanoidGame::log_telemetry() const
+{
+    const RenderStats& stats = m_screen.get_render_stats();
+    SDL_LogDebug(
+        SDL_LogCategory::SDL_LOG_CATEGORY_RENDER,
+        "Telemetry: %d commands, %d draw calls, %d state changes (%d color, %d texture), %llu physics steps, %zu of %zu brick chunks hot, %zu KB\n",
+        stats.commands, stats.draw_calls, stats.state_changes(), stats.color_changes, stats.texture_changes,
+        static_cast<unsigned long long>(m_scheduler.get_steps(m_physics_task)),
+        m_bricks->get_hot_chunk_count(), m_bricks->get_chunk_count(), m_bricks->get_resident_bytes() / 1024
+    );
+}
+
 bool ArkanoidGame::game_loop()
 {
     restart();
+    // The time on the end screen or of loading the level is not caught up on
+    m_scheduler.resync(m_clock->now());
     m_score.prepare(
         m_screen,
         SDL_Color{255, 255, 255, 255}
     );
+    m_hud_dirty = false;
 
+    bool first_frame = true;
     while(m_running && !m_hard_quit)
     {
-        bool score_changed = false;
+        // Nothing moves while the ball waits on the paddle and no key is held, block until that changes
+        if (m_idle_rendering && !first_frame && !m_ball.is_moving() && m_last_input == 0)
+        {
+            wait_for_activity();
+            m_last_frame_start = 0;     // the wait is not a slow frame
+            m_scheduler.resync(m_clock->now());
+        }
+        first_frame = false;
+
+        FrameTimes times;
+        const uint64_t frame_allocations = get_allocation_count();
         m_frame_limiter.start_frame();
+        times.start = m_wall_clock.now();
+        const uint64_t now = m_frame_limiter.get_frame_start();
         
         poll_for_events();
-        player_input();
-
-        if (m_ball.is_moving())
+        if (m_seek_pending)
         {
-            score_changed = m_ball.interact(m_screen, m_paddle, m_bricks, m_score);
-        }
-        else
-        {
-            m_ball.reset_to_paddle(m_paddle);
+            seek_replay();
+            m_scheduler.resync(now);    // the seek replaced the steps that came due
         }
+        times.polled = m_wall_clock.now();
 
-        if (m_score.get_balls_remaining() < 0 || m_bricks.get_brick_count() == 0)
+        // Physics at its own fixed rate, as many steps as came due since the last frame
+        const int physics_steps = m_scheduler.due(m_physics_task, now);
+        for (int step = 0; step < physics_steps && m_running && !m_hard_quit; step++)
         {
-            m_running = false;
+            if (m_input_recorder && m_input_recorder->keyframe_due())
+            {
+                save_state(m_state);
+                m_input_recorder->keyframe(m_state);
+            }
+            const uint64_t input_start = m_wall_clock.now();
+            player_input(m_scheduler.get_step_time(m_physics_task, step));
+            times.input_ns += m_wall_clock.now() - input_start;
+            step_physics();
         }
+        times.simulated = m_wall_clock.now();
     
+        // Rendering at the display rate, once per frame. The camera follows the ball over a playfield larger than
+        // the window, only the bricks in its view are decoded and drawn.
+        const SDL_Rect* ball = m_ball.get();
+        m_screen.look_at(ball->x + ball->w / 2, ball->y + ball->h / 2);
+        m_bricks->page(m_screen.get_view(), std::span<const SDL_Rect>(ball, 1));
         m_screen.clear(SDL_Color{0, 0, 0, 255});
         m_paddle.draw(m_screen, SDL_Color{255, 255, 255, 255});
         m_ball.draw(m_screen, SDL_Color{0, 255, 0, 255});
-        m_bricks.draw(m_screen);
+        m_bricks->draw(m_screen);
+        times.drawn = m_wall_clock.now();
 
-        if (score_changed)
+        // The score text is rebuilt at the HUD rate at most, the last prepared text is drawn in between
+        if (m_scheduler.due(m_hud_task, now) > 0 && m_hud_dirty)
         {
             m_score.prepare(m_screen, SDL_Color{255, 255, 255, 255});
+            m_hud_dirty = false;
         }
         m_score.draw(m_screen);
+        times.hud = m_wall_clock.now();
+        m_screen.render();
+        times.rendered = m_wall_clock.now();
 
-        m_screen.present();
+        present();
+        m_frame_limiter.end_work();
+        times.presented = m_wall_clock.now();
+        record_frame_times(times);
+
+        if (m_scheduler.due(m_telemetry_task, now) > 0)
+        {
+            log_telemetry();
+        }
+        // The frame is done, the report of a finished benchmark may allocate
+        const uint64_t allocated = get_allocation_count() - frame_allocations;
+        if (m_alloc_check && allocated > 0 && m_frames >= m_alloc_warmup_frames)
+        {
+            if (m_allocating_frames++ < 10)     // the first few are enough to find the culprit
+            {
+                SDL_LogError(
+                    SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION,
+                    "Frame %llu allocated %llu times\n",
+                    static_cast<unsigned long long>(m_frames),
+                    static_cast<unsigned long long>(allocated)
+                );
+            }
+        }
+        if (m_benchmark_frames > 0 && ++m_frames == m_benchmark_frames)
+        {
+            write_benchmark_report();
+            m_hard_quit = true;
+        }
         m_frame_limiter.limit_to_desired();
     }
     return m_hard_quit;
 }
 
+uint64_t ArkanoidGame::get_allocating_frames() const
+{
+    return m_allocating_frames;
+}
+
 bool ArkanoidGame::show_end_screen()
 {
     m_score.change_font_size(33);
@@ -159,18 +744,26 @@ bool ArkanoidGame::show_end_screen()
         snprintf(status_string, 75 ,"       Game Over!       \n\nQ to quit / R to restart");
     }
     m_score.prepare(m_screen, status_string, color);
-    m_score.draw(
-        m_screen, 
-        (m_screen.width() - m_score.get_text_width())/2, 
-        (m_screen.height() - m_score.get_text_height())/2
-    );
     
     m_running = true;
+    m_last_frame_start = 0;     // the end screen frames are not timed
+    bool first_frame = true;
     while(m_running)
     {
+        // The end screen is static, only redraw when there is input or the window needs it
+        if (m_idle_rendering && !first_frame)
+        {
+            wait_for_activity();
+            if (m_hard_quit)
+            {
+                break;
+            }
+        }
+        first_frame = false;
+
         m_frame_limiter.start_frame();
         poll_for_events();
-        player_input(true);
+        player_input(m_clock->now(), true);
 
         m_screen.clear(SDL_Color{0, 0, 0, 255});
         m_score.draw(
@@ -178,7 +771,7 @@ bool ArkanoidGame::show_end_screen()
             (m_screen.width() - m_score.get_text_width())/2, 
             (m_screen.height() - m_score.get_text_height())/2
         );
-        m_screen.present();
+        present();
         m_frame_limiter.limit_to_desired();
     }
     return m_restart;
@@ -1,3 +1,5 @@
+#include <cstdlib>
+
 #include "SDL.h"
 
 #include "Screen.h"
@@ -11,12 +13,16 @@ Ball::Ball(
     int ball_size,
     int velocity_x, 
     int velocity_y, 
-    bool is_moving
+    bool is_moving,
+    int speed_rate,
+    int tick_rate
 ):
     m_rect{.x = 0, .y = 0, .w = ball_size, .h = ball_size},
     m_velocity_x{velocity_x},
     m_velocity_y{velocity_y},
     m_is_moving{is_moving},
+    m_speed_rate{speed_rate},
+    m_tick_rate{tick_rate},
     m_original_velocity_x{velocity_x},
     m_original_velocity_y{velocity_y}
 {
@@ -45,22 +51,16 @@ bool Ball::interact(
 
     if (!paddle_collision)   // if ball collided with the paddle, no need to check for brick collisions
     {
-        // Brick collisions
-        for (auto& brick : bricks)
+        // Brick collisions, only the chunks around the ball are searched
+        if (const Brick* brick = bricks.hit(m_rect))
         {
-            if (brick.is_visible() && SDL_HasIntersection(&m_rect, brick.get()))
-            {
-                bricks.decrement_counter();
-                brick.set_visible(false);
-                bounce_from_brick(brick);
-                score.add_points(brick.get_points());
-                score_changed = true;
-                break;
-            }
+            bounce_from_brick(*brick);
+            score.add_points(brick->get_points());
+            score_changed = true;
         }
 
         // Reset if the ball falls below the paddle
-        if (m_rect.y > screen.height()) 
+        if (m_rect.y > screen.bottom()) 
         {
             reset_to_paddle(paddle);   // Ball needs to be reset
             score_changed = true;
@@ -80,6 +80,11 @@ bool Ball::is_moving() const
     return m_is_moving;
 }
 
+const SDL_Rect* Ball::get() const
+{
+    return &m_rect;
+}
+
 void Ball::set_velocity_x(const int velocity)
 {
     m_velocity_x = velocity;
@@ -96,19 +101,43 @@ void Ball::reset_to_paddle(const Paddle& paddle)
     m_rect.y = paddle.top() - 1 - m_rect.h;
     m_velocity_x = m_original_velocity_x;
     m_velocity_y = m_original_velocity_y;
+    m_remainder_x = 0;
+    m_remainder_y = 0;
     m_is_moving = false;
 }
 
+Ball::State Ball::get_state() const
+{
+    return State{m_rect.x, m_rect.y, m_velocity_x, m_velocity_y, m_remainder_x, m_remainder_y, m_is_moving};
+}
+
+void Ball::set_state(const State& state)
+{
+    m_rect.x = state.x;
+    m_rect.y = state.y;
+    m_velocity_x = state.velocity_x;
+    m_velocity_y = state.velocity_y;
+    m_remainder_x = state.remainder_x;
+    m_remainder_y = state.remainder_y;
+    m_is_moving = state.is_moving;
+}
+
 void Ball::draw(Screen& screen, SDL_Color color)
 {
-    SDL_SetRenderDrawColor(screen.get_renderer_ptr_raw(), color.r, color.g, color.b, color.a);
-    SDL_RenderFillRect(screen.get_renderer_ptr_raw(), &m_rect);
+    screen.fill_rect(screen.to_screen(m_rect), color, RenderLayer::Entities);
 }
 
 void Ball::move_forward()
 {
-    m_rect.x += m_velocity_x;
-    m_rect.y += m_velocity_y;
+    // Whole pixels of the step, the fractions carry over. Kept as distances so a bounce does not flip them.
+    m_remainder_x += std::abs(m_velocity_x) * m_speed_rate;
+    m_remainder_y += std::abs(m_velocity_y) * m_speed_rate;
+    const int pixels_x = m_remainder_x / m_tick_rate;
+    const int pixels_y = m_remainder_y / m_tick_rate;
+    m_remainder_x -= pixels_x * m_tick_rate;
+    m_remainder_y -= pixels_y * m_tick_rate;
+    m_rect.x += m_velocity_x < 0 ? -pixels_x : pixels_x;
+    m_rect.y += m_velocity_y < 0 ? -pixels_y : pixels_y;
 }
 
 void Ball::bounce_from_screen(const Screen& screen)
@@ -0,0 +1,111 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <memory_resource>
+#include <vector>
+
+#include "SDL.h"
+
+#include "Brick.h"
+#include "MappedFile.h"
+
+#include "BinaryLevelLayout.h"
+
+namespace
+{
+    constexpr uint32_t max_palette_size = level_max_palette_size;
+    constexpr uint32_t max_dimension = 1 << 16;
+
+    [[noreturn]] void invalid_level(const std::string_view path, const char* reason)
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Level %s: %s\n", path.data(), reason);
+        throw std::runtime_error("Invalid level!\n");
+    }
+}
+
+BinaryLevelLayout::BinaryLevelLayout(const std::string_view path):
+    m_file(path)
+{
+    if (m_file.size() < sizeof(LevelFileHeader))
+    {
+        invalid_level(path, "not a level");
+    }
+    std::memcpy(&m_header, m_file.data(), sizeof(m_header));
+    if (std::memcmp(m_header.magic, level_magic, sizeof(level_magic)) != 0)
+    {
+        invalid_level(path, "not a level");
+    }
+    if (m_header.version != level_version)
+    {
+        invalid_level(path, "unsupported version");
+    }
+    if (m_header.width == 0 || m_header.height == 0 || m_header.width > max_dimension || m_header.height > max_dimension)
+    {
+        invalid_level(path, "invalid playfield size");
+    }
+    if (m_header.palette_size == 0 || m_header.palette_size > max_palette_size)
+    {
+        invalid_level(path, "invalid palette");
+    }
+    // 64 bit arithmetic, the counts come from the file
+    const uint64_t expected_size = sizeof(LevelFileHeader)
+        + uint64_t(m_header.palette_size) * 4
+        + uint64_t(m_header.brick_count) * sizeof(LevelFileBrick);
+    if (m_file.size() != expected_size)
+    {
+        invalid_level(path, "size does not match the header");
+    }
+    m_palette = m_file.data() + sizeof(LevelFileHeader);
+    m_records = m_palette + m_header.palette_size * 4;
+
+    // One pass over the records, create_bricks() can index the palette unchecked and every brick is a non empty
+    // rectangle inside the playfield, as TextLevel makes them. The coordinates come from the file, 64 bit arithmetic.
+    for (uint32_t i = 0; i < m_header.brick_count; i++)
+    {
+        LevelFileBrick record;
+        std::memcpy(&record, m_records + i * sizeof(LevelFileBrick), sizeof(record));
+        if (record.color >= m_header.palette_size)
+        {
+            invalid_level(path, "brick color outside of the palette");
+        }
+        if (record.width == 0 || record.height == 0
+            || record.x < 0 || int64_t(record.x) + record.width > int64_t(m_header.width)
+            || record.y < 0 || int64_t(record.y) + record.height > int64_t(m_header.height))
+        {
+            invalid_level(path, "brick outside of the playfield");
+        }
+    }
+}
+
+std::pmr::vector<Brick> BinaryLevelLayout::create_bricks(std::pmr::memory_resource* arena)
+{
+    SDL_Color palette[max_palette_size] = {};
+    std::memcpy(palette, m_palette, m_header.palette_size * 4);
+
+    std::pmr::vector<Brick> bricks(arena);
+    bricks.reserve(m_header.brick_count);
+    for (uint32_t i = 0; i < m_header.brick_count; i++)
+    {
+        LevelFileBrick record;
+        std::memcpy(&record, m_records + i * sizeof(LevelFileBrick), sizeof(record));
+        bricks.emplace_back(record.x, record.y, record.width, record.height, record.points, SDL_Color(palette[record.color]));
+    }
+    return bricks;
+}
+
+int BinaryLevelLayout::get_width() const
+{
+    return static_cast<int>(m_header.width);
+}
+
+int BinaryLevelLayout::get_height() const
+{
+    return static_cast<int>(m_header.height);
+}
+
+size_t BinaryLevelLayout::get_brick_count() const
+{
+    return m_header.brick_count;
+}
@@ -54,16 +54,7 @@ SDL_Color Brick::get_color() const
 
 void Brick::draw(Screen& screen)
 {
-    if (SDL_SetRenderDrawColor(screen.get_renderer_ptr_raw(), m_color.r, m_color.g, m_color.b, m_color.a) != 0)
-    {
-        SDL_Log("SDL_SetRenderDrawColor failed %s \n", SDL_GetError());
-        throw std::runtime_error("SDL_SetRenderDrawColor failed");
-    }
-    if (SDL_RenderFillRect(screen.get_renderer_ptr_raw(), &m_rect) != 0)
-    {
-        SDL_Log("SDL_RenderFillRect failed %s \n", SDL_GetError());
-        throw std::runtime_error("SDL_RenderFillRect failed");
-    }
+    screen.fill_rect(screen.to_screen(m_rect), m_color, RenderLayer::Bricks);
 }
 
 SDL_Rect* Brick::get()
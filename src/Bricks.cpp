@@ -1,34 +1,316 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <span>
+#include <utility>
 #include <vector>
 
 #include "SDL.h"
 
 #include "Brick.h"
 #include "BricksLayout.h"
+#include "Arena.h"
 
 #include "Bricks.h"
 
+namespace
+{
+    /**
+     * Append an unsigned LEB128 varint, 7 bits per byte with the high bit marking more bytes.
+     */
+    void put_varint(std::pmr::vector<uint8_t>& buffer, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            buffer.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<uint8_t>(value));
+    }
+
+    /**
+     * Read a varint written by put_varint(). The chunks are packed by Bricks itself, no bounds are checked.
+     */
+    uint64_t get_varint(const uint8_t*& position)
+    {
+        uint64_t value = 0;
+        for (int shift = 0; ; shift += 7)
+        {
+            const uint8_t byte = *position++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return value;
+            }
+        }
+    }
+
+    /**
+     * Signed values as varints, small magnitudes in few bytes either way.
+     */
+    uint64_t zigzag(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t unzigzag(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    bool same_color(const SDL_Color& a, const SDL_Color& b)
+    {
+        return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+    }
+
+    /**
+     * Cell of the chunk grid holding a coordinate, clamped to the grid.
+     */
+    int to_cell(int64_t position, int origin, int cells)
+    {
+        const int64_t cell = (position - origin) / Bricks::chunk_size;
+        return static_cast<int>(std::clamp<int64_t>(cell, 0, cells - 1));
+    }
+}
+
 Bricks::Bricks(BricksLayout& layout)
 {
-    m_bricks = layout.create_bricks();
-    m_brick_count = m_bricks.size();
+    // The layout's bricks and the sorting and packing buffers are only needed here, they all go with the scratch arena
+    Arena scratch;
+    const std::pmr::vector<Brick> bricks = layout.create_bricks(&scratch);
+    m_size = bricks.size();
+    m_brick_count = static_cast<int>(m_size);
+    if (m_size == 0)
+    {
+        return;
+    }
+
+    int max_x = bricks.front().left();
+    int max_y = bricks.front().top();
+    m_origin_x = max_x;
+    m_origin_y = max_y;
+    for (const Brick& brick : bricks)
+    {
+        m_origin_x = std::min(m_origin_x, brick.left());
+        m_origin_y = std::min(m_origin_y, brick.top());
+        max_x = std::max(max_x, brick.left());
+        max_y = std::max(max_y, brick.top());
+        m_max_width = std::max(m_max_width, brick.right() - brick.left());
+        m_max_height = std::max(m_max_height, brick.bottom() - brick.top());
+    }
+    m_cols = static_cast<int>((static_cast<int64_t>(max_x) - m_origin_x) / chunk_size + 1);
+    m_rows = static_cast<int>((static_cast<int64_t>(max_y) - m_origin_y) / chunk_size + 1);
+
+    // Counting sort of the bricks by cell, stable so every chunk lists its bricks in layout order
+    std::pmr::vector<uint32_t> cells(m_size, &scratch);
+    std::pmr::vector<uint32_t> starts(static_cast<size_t>(m_cols) * m_rows + 1, 0, &scratch);
+    for (size_t i = 0; i < m_size; i++)
+    {
+        cells[i] = static_cast<uint32_t>(to_cell(bricks[i].top(), m_origin_y, m_rows) * m_cols + to_cell(bricks[i].left(), m_origin_x, m_cols));
+        starts[cells[i] + 1]++;
+    }
+    for (size_t cell = 1; cell < starts.size(); cell++)
+    {
+        starts[cell] += starts[cell - 1];
+    }
+    std::pmr::vector<uint32_t> order(m_size, &scratch);
+    std::pmr::vector<uint32_t> next(starts.begin(), starts.end() - 1, &scratch);
+    size_t chunk_count = 0;
+    for (size_t i = 0; i < m_size; i++)
+    {
+        chunk_count += next[cells[i]] == starts[cells[i]] ? 1 : 0;
+        order[next[cells[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    // The chunks are packed on the scratch arena first, their size decides the block of the level arena
+    std::pmr::vector<uint8_t> packed(&scratch);
+    std::pmr::vector<size_t> packed_ends(&scratch);
+    packed_ends.reserve(chunk_count);
+    for (size_t cell = 0; cell + 1 < starts.size(); cell++)
+    {
+        if (starts[cell] != starts[cell + 1])
+        {
+            pack(packed, bricks, std::span<const uint32_t>(order).subspan(starts[cell], starts[cell + 1] - starts[cell]),
+                m_origin_x + static_cast<int>(cell % m_cols) * chunk_size, m_origin_y + static_cast<int>(cell / m_cols) * chunk_size);
+            packed_ends.push_back(packed.size());
+        }
+    }
+
+    // Everything kept lives in the level arena, in one block sized for all of it with room for the alignment of
+    // every allocation, and every container is sized exactly so nothing is copied into it twice
+    constexpr size_t padding = alignof(std::max_align_t);
+    m_arena.reserve(
+        (m_size + 7) / 8 + padding
+        + static_cast<size_t>(m_cols) * m_rows * sizeof(int32_t) + padding
+        + chunk_count * sizeof(Chunk) + padding
+        + packed.size() + chunk_count * padding
+    );
+    m_visible.assign((m_size + 7) / 8, 0xFF);
+    m_grid.assign(static_cast<size_t>(m_cols) * m_rows, -1);
+    m_chunks.reserve(chunk_count);
+    size_t packed_start = 0;
+    for (size_t cell = 0; cell + 1 < starts.size(); cell++)
+    {
+        if (starts[cell] == starts[cell + 1])
+        {
+            continue;
+        }
+        Chunk chunk(&m_arena);
+        chunk.x = m_origin_x + static_cast<int>(cell % m_cols) * chunk_size;
+        chunk.y = m_origin_y + static_cast<int>(cell / m_cols) * chunk_size;
+        chunk.count = starts[cell + 1] - starts[cell];
+        m_max_count = std::max(m_max_count, chunk.count);
+        const size_t packed_end = packed_ends[m_chunks.size()];
+        chunk.packed.assign(packed.begin() + packed_start, packed.begin() + packed_end);
+        packed_start = packed_end;
+        m_grid[cell] = static_cast<int32_t>(m_chunks.size());
+        m_chunks.push_back(std::move(chunk));
+    }
+}
+
+std::vector<Brick> Bricks::get_bricks() const
+{
+    std::vector<Brick> bricks(m_size, Brick(0, 0, 0, 0, 0, SDL_Color{0, 0, 0, 0}));
+    std::pmr::vector<Brick> decoded;
+    std::pmr::vector<uint32_t> indices;
+    for (const Chunk& chunk : m_chunks)
+    {
+        unpack(chunk, decoded, indices);
+        for (size_t i = 0; i < decoded.size(); i++)
+        {
+            decoded[i].set_visible(m_visible[indices[i] / 8] & (1 << (indices[i] % 8)));
+            bricks[indices[i]] = decoded[i];
+        }
+    }
+    return bricks;
 }
 
-std::vector<Brick>& Bricks::get_bricks()
+size_t Bricks::size() const
 {
-    return m_bricks;
+    return m_size;
 }
 
 void Bricks::draw(Screen& screen)
 {
-    int brick_count = 0;
-    for (auto& brick : m_bricks)
+    // Only the chunks that can reach into the view are visited, and only their bricks in the view drawn
+    const SDL_Rect view = screen.get_view();
+    int first_col, first_row, last_col, last_row;
+    if (!cell_range(view, 0, first_col, first_row, last_col, last_row))
+    {
+        return;
+    }
+    for (int row = first_row; row <= last_row; row++)
+    {
+        for (int col = first_col; col <= last_col; col++)
+        {
+            const int32_t chunk = m_grid[row * m_cols + col];
+            if (chunk < 0)
+            {
+                continue;
+            }
+            decode(chunk);
+            for (auto& brick : m_chunks[chunk].bricks)
+            {
+                if (brick.is_visible() && SDL_HasIntersection(&view, brick.get()))
+                {
+                    brick.draw(screen);
+                }
+            }
+        }
+    }
+}
+
+const Brick* Bricks::hit(const SDL_Rect& rect)
+{
+    int first_col, first_row, last_col, last_row;
+    if (!cell_range(rect, 0, first_col, first_row, last_col, last_row))
+    {
+        return nullptr;
+    }
+    // The first hit brick in layout order, as when all the bricks were one list
+    Brick* hit = nullptr;
+    uint32_t hit_index = 0;
+    for (int row = first_row; row <= last_row; row++)
+    {
+        for (int col = first_col; col <= last_col; col++)
+        {
+            const int32_t chunk = m_grid[row * m_cols + col];
+            if (chunk < 0)
+            {
+                continue;
+            }
+            decode(chunk);
+            Chunk& current = m_chunks[chunk];
+            for (size_t i = 0; i < current.bricks.size(); i++)
+            {
+                if (hit && current.indices[i] >= hit_index)
+                {
+                    break;      // the rest of the chunk comes later in layout order
+                }
+                Brick& brick = current.bricks[i];
+                if (brick.is_visible() && SDL_HasIntersection(&rect, brick.get()))
+                {
+                    hit = &brick;
+                    hit_index = current.indices[i];
+                    break;
+                }
+            }
+        }
+    }
+    if (hit)
+    {
+        hit->set_visible(false);
+        m_visible[hit_index / 8] &= static_cast<uint8_t>(~(1 << (hit_index % 8)));
+        m_brick_count--;
+    }
+    return hit;
+}
+
+void Bricks::page(const SDL_Rect& view, std::span<const SDL_Rect> focus)
+{
+    m_page++;
+    auto for_each_chunk = [this, &view, &focus](auto&& visit) {
+        auto visit_rect = [this, &visit](const SDL_Rect& rect) {
+            int first_col, first_row, last_col, last_row;
+            if (!cell_range(rect, hot_margin, first_col, first_row, last_col, last_row))
+            {
+                return;
+            }
+            for (int row = first_row; row <= last_row; row++)
+            {
+                for (int col = first_col; col <= last_col; col++)
+                {
+                    const int32_t chunk = m_grid[row * m_cols + col];
+                    if (chunk >= 0)
+                    {
+                        visit(static_cast<uint32_t>(chunk));
+                    }
+                }
+            }
+        };
+        visit_rect(view);
+        for (const SDL_Rect& rect : focus)
+        {
+            visit_rect(rect);
+        }
+    };
+
+    // Evict before decoding, so even a jump of the view decodes into the buffers of the chunks it left
+    for_each_chunk([this](uint32_t chunk) { m_chunks[chunk].wanted = m_page; });
+    for (size_t i = 0; i < m_hot.size(); )
     {
-        if (brick.is_visible())
+        if (m_chunks[m_hot[i]].wanted != m_page)
         {
-            brick.draw(screen);
-            brick_count++;
+            evict(m_hot[i]);    // swaps the last hot chunk into place
+        }
+        else
+        {
+            i++;
         }
     }
+    for_each_chunk([this](uint32_t chunk) { decode(chunk); });
 }
 
 int Bricks::get_brick_count() const
@@ -41,21 +323,175 @@ void Bricks::set_brick_count(int count)
     m_brick_count = count;
 }
 
-void Bricks::decrement_counter()
+void Bricks::get_visibility(uint8_t* bits) const
+{
+    std::memcpy(bits, m_visible.data(), m_visible.size());
+}
+
+void Bricks::set_visibility(const uint8_t* bits)
 {
-    m_brick_count--;
+    std::memcpy(m_visible.data(), bits, m_visible.size());
+    for (const uint32_t chunk : m_hot)
+    {
+        Chunk& current = m_chunks[chunk];
+        for (size_t i = 0; i < current.bricks.size(); i++)
+        {
+            current.bricks[i].set_visible(m_visible[current.indices[i] / 8] & (1 << (current.indices[i] % 8)));
+        }
+    }
 }
 
 void Bricks::reset()
 {
-    for (auto& brick : m_bricks)
+    std::fill(m_visible.begin(), m_visible.end(), 0xFF);
+    for (const uint32_t chunk : m_hot)
+    {
+        for (auto& brick : m_chunks[chunk].bricks)
+        {
+            brick.set_visible(true);
+        }
+    }
+    m_brick_count = static_cast<int>(m_size);
+}
+
+size_t Bricks::get_chunk_count() const
+{
+    return m_chunks.size();
+}
+
+size_t Bricks::get_hot_chunk_count() const
+{
+    return m_hot.size();
+}
+
+size_t Bricks::get_resident_bytes() const
+{
+    return m_arena.used();
+}
+
+bool Bricks::cell_range(const SDL_Rect& rect, int margin, int& first_col, int& first_row, int& last_col, int& last_row) const
+{
+    if (m_chunks.empty())
+    {
+        return false;
+    }
+    // A brick reaches into the rectangle from up to a brick size to the left and above of it
+    const int64_t grow = static_cast<int64_t>(margin) * chunk_size;
+    const int64_t left = static_cast<int64_t>(rect.x) - m_max_width + 1 - grow;
+    const int64_t top = static_cast<int64_t>(rect.y) - m_max_height + 1 - grow;
+    const int64_t right = static_cast<int64_t>(rect.x) + rect.w - 1 + grow;
+    const int64_t bottom = static_cast<int64_t>(rect.y) + rect.h - 1 + grow;
+    if (right < m_origin_x || bottom < m_origin_y
+        || left >= m_origin_x + static_cast<int64_t>(m_cols) * chunk_size
+        || top >= m_origin_y + static_cast<int64_t>(m_rows) * chunk_size)
+    {
+        return false;
+    }
+    first_col = to_cell(left, m_origin_x, m_cols);
+    first_row = to_cell(top, m_origin_y, m_rows);
+    last_col = to_cell(right, m_origin_x, m_cols);
+    last_row = to_cell(bottom, m_origin_y, m_rows);
+    return true;
+}
+
+void Bricks::decode(uint32_t chunk)
+{
+    Chunk& current = m_chunks[chunk];
+    if (current.hot)
+    {
+        return;
+    }
+    if (!m_spare_bricks.empty())
+    {
+        current.bricks = std::move(m_spare_bricks.back());
+        current.indices = std::move(m_spare_indices.back());
+        m_spare_bricks.pop_back();
+        m_spare_indices.pop_back();
+    }
+    current.bricks.reserve(m_max_count);
+    current.indices.reserve(m_max_count);
+    unpack(current, current.bricks, current.indices);
+    for (size_t i = 0; i < current.bricks.size(); i++)
+    {
+        current.bricks[i].set_visible(m_visible[current.indices[i] / 8] & (1 << (current.indices[i] % 8)));
+    }
+    current.hot = true;
+    m_hot.push_back(chunk);
+}
+
+void Bricks::evict(uint32_t chunk)
+{
+    Chunk& current = m_chunks[chunk];
+    // The visibility lives in m_visible, the decoded bricks can go as they are. The buffers stay for the chunks
+    // coming into the view.
+    m_spare_bricks.push_back(std::move(current.bricks));
+    m_spare_indices.push_back(std::move(current.indices));
+    current.bricks = std::pmr::vector<Brick>(&m_arena);
+    current.indices = std::pmr::vector<uint32_t>(&m_arena);
+    current.hot = false;
+    auto position = std::find(m_hot.begin(), m_hot.end(), chunk);
+    *position = m_hot.back();
+    m_hot.pop_back();
+}
+
+void Bricks::pack(std::pmr::vector<uint8_t>& packed, std::span<const Brick> bricks, std::span<const uint32_t> indices, int origin_x, int origin_y)
+{
+    // Per brick: varint of the index delta with a changed color flag in bit 0, zigzag varints of the position delta,
+    // of the size and points, then the color if it changed. Rows of similar bricks take a few bytes each.
+    uint32_t last_index = 0;
+    int64_t last_x = origin_x;
+    int64_t last_y = origin_y;
+    SDL_Color last_color{0, 0, 0, 0};
+    bool first = true;
+    for (const uint32_t index : indices)
     {
-        brick.set_visible(true);
+        const Brick& brick = bricks[index];
+        const SDL_Color color = brick.get_color();
+        const bool color_changed = first || !same_color(color, last_color);
+        put_varint(packed, static_cast<uint64_t>(index - last_index) << 1 | (color_changed ? 1 : 0));
+        put_varint(packed, zigzag(brick.left() - last_x));
+        put_varint(packed, zigzag(brick.top() - last_y));
+        put_varint(packed, zigzag(brick.right() - brick.left()));
+        put_varint(packed, zigzag(brick.bottom() - brick.top()));
+        put_varint(packed, zigzag(brick.get_points()));
+        if (color_changed)
+        {
+            packed.insert(packed.end(), {color.r, color.g, color.b, color.a});
+        }
+        last_index = index;
+        last_x = brick.left();
+        last_y = brick.top();
+        last_color = color;
+        first = false;
     }
-    m_brick_count = m_bricks.size();
 }
 
-std::vector<Brick>::iterator Bricks::begin() { return this->m_bricks.begin(); }
-std::vector<Brick>::const_iterator Bricks::cbegin() const { return this->m_bricks.begin(); }
-std::vector<Brick>::iterator Bricks::end() { return this->m_bricks.end(); }
-std::vector<Brick>::const_iterator Bricks::cend() const { return this->m_bricks.end(); }
+void Bricks::unpack(const Chunk& chunk, std::pmr::vector<Brick>& bricks, std::pmr::vector<uint32_t>& indices)
+{
+    bricks.clear();
+    indices.clear();
+    bricks.reserve(chunk.count);
+    indices.reserve(chunk.count);
+    const uint8_t* position = chunk.packed.data();
+    uint32_t index = 0;
+    int64_t x = chunk.x;
+    int64_t y = chunk.y;
+    SDL_Color color{0, 0, 0, 0};
+    for (uint32_t i = 0; i < chunk.count; i++)
+    {
+        const uint64_t head = get_varint(position);
+        index += static_cast<uint32_t>(head >> 1);
+        x += unzigzag(get_varint(position));
+        y += unzigzag(get_varint(position));
+        const int width = static_cast<int>(unzigzag(get_varint(position)));
+        const int height = static_cast<int>(unzigzag(get_varint(position)));
+        const int points = static_cast<int>(unzigzag(get_varint(position)));
+        if (head & 1)
+        {
+            color = SDL_Color{position[0], position[1], position[2], position[3]};
+            position += 4;
+        }
+        bricks.emplace_back(static_cast<int>(x), static_cast<int>(y), width, height, points, SDL_Color(color));
+        indices.push_back(index);
+    }
+}
@@ -0,0 +1,60 @@
+#include <cstdint>
+
+#include "SDL.h"
+
+#include "Clock.h"
+
+namespace
+{
+    constexpr uint64_t ns_per_second = 1'000'000'000;
+    constexpr uint64_t ns_per_ms = 1'000'000;
+}
+
+uint64_t RealClock::now() const
+{
+    return performance_now();
+}
+
+void RealClock::sleep(uint32_t ms)
+{
+    SDL_Delay(ms);
+}
+
+void RealClock::spin_until(uint64_t deadline)
+{
+    while (performance_now() < deadline)
+    {
+        SDL_CPUPauseInstruction();
+    }
+}
+
+uint64_t RealClock::performance_now()
+{
+    static const uint64_t frequency = SDL_GetPerformanceFrequency();
+    const uint64_t counter = SDL_GetPerformanceCounter();
+    // Split to avoid overflowing counter * 1e9
+    return (counter / frequency) * ns_per_second + (counter % frequency) * ns_per_second / frequency;
+}
+
+VirtualClock::VirtualClock(uint64_t start):
+    m_now{start != 0 ? start : 1}
+{
+}
+
+uint64_t VirtualClock::now() const
+{
+    return m_now;
+}
+
+void VirtualClock::sleep(uint32_t ms)
+{
+    m_now += ms * ns_per_ms;
+}
+
+void VirtualClock::spin_until(uint64_t deadline)
+{
+    if (deadline > m_now)
+    {
+        m_now = deadline;
+    }
+}
@@ -1,23 +1,109 @@
-#include "SDL.h"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+#include "Clock.h"
 
 #include "FrameLimiter.h"
 
-FrameLimiter::FrameLimiter(int desired_fps)
+namespace
+{
+    constexpr uint64_t ns_per_second = 1'000'000'000;
+    constexpr uint64_t ns_per_ms = 1'000'000;
+    constexpr uint64_t min_spin_margin = 250'000;      // always spin at least the last 0.25 ms
+    constexpr uint64_t max_spin_margin = 4'000'000;    // never spin for more than 4 ms
+    constexpr uint64_t work_margin = 500'000;          // safety margin over the longest recent frame
+}
+
+FrameLimiter::FrameLimiter(Clock& clock, int desired_fps, FramePacing pacing):
+    m_clock{clock},
+    m_desired_fps{desired_fps > 0 ? desired_fps : 60},
+    m_spin_margin{2'000'000},
+    m_pacing{pacing}
 {
-    m_desired_fps = desired_fps;
-    m_delta = 1000 / m_desired_fps;
 }
 
 void FrameLimiter::start_frame()
 {
-    m_start = SDL_GetTicks64();
+    m_start = m_clock.now();
+    if (m_origin == 0)
+    {
+        m_origin = m_start;
+        m_frame_index = 0;
+    }
+    // The low latency wait ended ahead of the deadline it aims at, the steady one right at the previous deadline
+    m_present_deadline = deadline(m_pacing == FramePacing::LowLatency ? m_frame_index : m_frame_index + 1);
+}
+
+void FrameLimiter::end_work()
+{
+    m_work[m_work_index] = m_clock.now() - m_start;
+    m_work_index = (m_work_index + 1) % work_history;
 }
 
 void FrameLimiter::limit_to_desired()
 {
-    float elapsed_ms = (SDL_GetTicks64() - m_start) ;
-    if (elapsed_ms < m_delta)
+    const uint64_t period = ns_per_second / m_desired_fps;
+    const uint64_t lead = m_pacing == FramePacing::LowLatency ? predicted_work() : 0;
+    const uint64_t target = deadline(m_frame_index + 1) - lead;
+    uint64_t current = m_clock.now();
+
+    if (current > target + period)
     {
-        SDL_Delay(m_delta - elapsed_ms);
+        // Fell behind by more than a frame (a hitch, an idle wait), restart the deadlines instead of catching up
+        m_origin = current;
+        m_frame_index = 0;
+        return;
+    }
+    m_frame_index++;
+
+    // Coarse sleep while the deadline is further away than the expected oversleep
+    while (current < target && target - current > m_spin_margin)
+    {
+        const uint32_t sleep_ms = static_cast<uint32_t>((target - current - m_spin_margin) / ns_per_ms);
+        if (sleep_ms == 0)
+        {
+            break;
+        }
+        m_clock.sleep(sleep_ms);
+        const uint64_t after = m_clock.now();
+        const uint64_t slept = after - current;
+        const uint64_t overslept = slept > sleep_ms * ns_per_ms ? slept - sleep_ms * ns_per_ms : 0;
+
+        // Grow the margin right away on a long sleep, shrink it slowly after short ones
+        const uint64_t wanted_margin = std::clamp(overslept + min_spin_margin, min_spin_margin, max_spin_margin);
+        if (wanted_margin > m_spin_margin)
+        {
+            m_spin_margin = wanted_margin;
+        }
+        else
+        {
+            m_spin_margin -= (m_spin_margin - wanted_margin) / 16;
+        }
+        current = after;
     }
+
+    // Fine spin for the rest
+    m_clock.spin_until(target);
+}
+
+uint64_t FrameLimiter::get_frame_start() const
+{
+    return m_start;
+}
+
+uint64_t FrameLimiter::get_present_deadline() const
+{
+    return m_present_deadline;
+}
+
+uint64_t FrameLimiter::predicted_work() const
+{
+    const uint64_t longest = *std::max_element(std::begin(m_work), std::end(m_work));
+    return std::min(longest + work_margin, ns_per_second / m_desired_fps);
+}
+
+uint64_t FrameLimiter::deadline(uint64_t frame_index) const
+{
+    return m_origin + frame_index * ns_per_second / m_desired_fps;
 }
@@ -0,0 +1,261 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+#include "SDL.h"
+
+#include "FrameStats.h"
+
+namespace
+{
+    constexpr uint64_t ns_per_second = 1'000'000'000;
+
+    double to_ms(uint64_t ns)
+    {
+        return static_cast<double>(ns) / 1e6;
+    }
+
+    /**
+     * Increment of an atomic with a single writer. A plain load and store, no locked read-modify-write needed.
+     */
+    void add(std::atomic<uint64_t>& counter, uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::record(uint64_t ns)
+{
+    add(m_buckets[bucket_of(ns)], 1);
+    add(m_count, 1);
+    add(m_sum, ns);
+    if (ns > m_max.load(std::memory_order_relaxed))
+    {
+        m_max.store(ns, std::memory_order_relaxed);
+    }
+}
+
+uint64_t LatencyHistogram::percentile(double fraction) const
+{
+    const uint64_t total = count();
+    if (total == 0)
+    {
+        return 0;
+    }
+    // Rank of the wanted value, 1 based
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * static_cast<double>(total) + 0.5));
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < bucket_count; bucket++)
+    {
+        seen += m_buckets[bucket].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            return std::min(value_of(bucket), max());
+        }
+    }
+    return max();
+}
+
+uint64_t LatencyHistogram::count() const
+{
+    return m_count.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::max() const
+{
+    return m_max.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::mean() const
+{
+    const uint64_t total = count();
+    return total ? m_sum.load(std::memory_order_relaxed) / total : 0;
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto& bucket : m_buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+int LatencyHistogram::bucket_of(uint64_t ns)
+{
+    if (ns < linear_limit)
+    {
+        return static_cast<int>(ns);
+    }
+    const int exponent = std::min(static_cast<int>(std::bit_width(ns)) - 1, max_exponent);
+    const int shift = exponent - sub_bucket_bits;
+    const int sub_bucket = static_cast<int>(std::min<uint64_t>(ns >> shift, (2 << sub_bucket_bits) - 1)) - (1 << sub_bucket_bits);
+    return linear_limit + (exponent - sub_bucket_bits - 1) * (1 << sub_bucket_bits) + sub_bucket;
+}
+
+uint64_t LatencyHistogram::value_of(int bucket)
+{
+    if (bucket < linear_limit)
+    {
+        return static_cast<uint64_t>(bucket);
+    }
+    const int group = (bucket - linear_limit) >> sub_bucket_bits;
+    const int sub_bucket = (bucket - linear_limit) & ((1 << sub_bucket_bits) - 1);
+    const int shift = group + 1;
+    const uint64_t lower = static_cast<uint64_t>((1 << sub_bucket_bits) + sub_bucket) << shift;
+    return lower + (uint64_t(1) << shift) / 2;
+}
+
+FrameStats::FrameStats(int fps, const std::string_view csv_path):
+    m_budget{ns_per_second / (fps > 0 ? fps : 60) * 21 / 20}     // 5% tolerance over 1 / fps
+{
+    if (csv_path.empty())
+    {
+        return;
+    }
+    m_csv.reset(std::fopen(csv_path.data(), "w"));
+    if (!m_csv)
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Could not open %s for writing\n", csv_path.data());
+        return;
+    }
+    std::fprintf(m_csv.get(), "second,frames,missed");
+    for (int channel = 0; channel < static_cast<int>(FrameChannel::Count); channel++)
+    {
+        const char* name = channel_name(static_cast<FrameChannel>(channel));
+        std::fprintf(m_csv.get(), ",%s_p50_ms,%s_p99_ms,%s_max_ms", name, name, name);
+    }
+    std::fprintf(m_csv.get(), "\n");
+}
+
+FrameStats::~FrameStats()
+{
+    log_summary();
+}
+
+void FrameStats::record(FrameChannel channel, uint64_t ns)
+{
+    m_total[static_cast<int>(channel)].record(ns);
+    m_window[static_cast<int>(channel)].record(ns);
+    if (channel == FrameChannel::Frame && ns > m_budget)
+    {
+        add(m_missed, 1);
+        add(m_window_missed, 1);
+    }
+}
+
+void FrameStats::end_frame(uint64_t now)
+{
+    if (m_window_start == 0)
+    {
+        m_window_start = now;
+        return;
+    }
+    if (now - m_window_start < ns_per_second)
+    {
+        return;
+    }
+
+    if (m_csv)
+    {
+        const LatencyHistogram& frames = m_window[static_cast<int>(FrameChannel::Frame)];
+        std::fprintf(
+            m_csv.get(), "%llu,%llu,%llu",
+            static_cast<unsigned long long>(m_window_index),
+            static_cast<unsigned long long>(frames.count()),
+            static_cast<unsigned long long>(m_window_missed.load(std::memory_order_relaxed))
+        );
+        for (const auto& histogram : m_window)
+        {
+            std::fprintf(
+                m_csv.get(), ",%.3f,%.3f,%.3f",
+                to_ms(histogram.percentile(0.5)), to_ms(histogram.percentile(0.99)), to_ms(histogram.max())
+            );
+        }
+        std::fprintf(m_csv.get(), "\n");
+    }
+
+    for (auto& histogram : m_window)
+    {
+        histogram.reset();
+    }
+    m_window_missed.store(0, std::memory_order_relaxed);
+    m_window_index++;
+    m_window_start = now;
+}
+
+const LatencyHistogram& FrameStats::get(FrameChannel channel) const
+{
+    return m_total[static_cast<int>(channel)];
+}
+
+uint64_t FrameStats::get_missed() const
+{
+    return m_missed.load(std::memory_order_relaxed);
+}
+
+void FrameStats::log_summary() const
+{
+    const LatencyHistogram& frames = get(FrameChannel::Frame);
+    SDL_Log(
+        "Frame stats: %llu frames, %llu over the %.2f ms budget\n",
+        static_cast<unsigned long long>(frames.count()),
+        static_cast<unsigned long long>(get_missed()),
+        to_ms(m_budget)
+    );
+    for (int channel = 0; channel < static_cast<int>(FrameChannel::Count); channel++)
+    {
+        const LatencyHistogram& histogram = m_total[channel];
+        SDL_Log(
+            "  %-8s p50 %7.3f ms | p95 %7.3f ms | p99 %7.3f ms | max %7.3f ms\n",
+            channel_name(static_cast<FrameChannel>(channel)),
+            to_ms(histogram.percentile(0.5)),
+            to_ms(histogram.percentile(0.95)),
+            to_ms(histogram.percentile(0.99)),
+            to_ms(histogram.max())
+        );
+    }
+}
+
+void FrameStats::write_json(std::FILE* file) const
+{
+    std::fprintf(file, "{");
+    for (int channel = 0; channel < static_cast<int>(FrameChannel::Count); channel++)
+    {
+        const LatencyHistogram& histogram = m_total[channel];
+        std::fprintf(
+            file,
+            "%s\n    \"%s\": {\"count\": %llu, \"mean_ms\": %.4f, \"p50_ms\": %.4f, \"p95_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f}",
+            channel == 0 ? "" : ",",
+            channel_name(static_cast<FrameChannel>(channel)),
+            static_cast<unsigned long long>(histogram.count()),
+            to_ms(histogram.mean()),
+            to_ms(histogram.percentile(0.5)),
+            to_ms(histogram.percentile(0.95)),
+            to_ms(histogram.percentile(0.99)),
+            to_ms(histogram.max())
+        );
+    }
+    std::fprintf(file, "\n  }");
+}
+
+const char* FrameStats::channel_name(FrameChannel channel)
+{
+    switch (channel)
+    {
+    case FrameChannel::Frame: return "frame";
+    case FrameChannel::Poll: return "poll";
+    case FrameChannel::Input: return "input";
+    case FrameChannel::Sim: return "sim";
+    case FrameChannel::Render: return "render";
+    case FrameChannel::Hud: return "hud";
+    case FrameChannel::Present: return "present";
+    case FrameChannel::Latency: return "latency";
+    default: return "unknown";
+    }
+}
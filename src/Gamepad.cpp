@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+
+#include "SDL.h"
+
+#include "Clock.h"
+#include "InputLog.h"
+#include "Paddle.h"
+
+#include "Gamepad.h"
+
+namespace
+{
+    constexpr int axis_max = 32767;
+    constexpr int idle_hz = 2;     // rate of looking for a controller while none is attached
+}
+
+Gamepad::Gamepad(int sample_hz, int deadzone):
+    m_deadzone{std::clamp(deadzone, 0, axis_max - 1)},
+    m_period{1'000'000'000ull / static_cast<uint64_t>(std::max(sample_hz, 1))}
+{
+    if (SDL_InitSubSystem(SDL_INIT_GAMECONTROLLER) < 0)
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Game controllers could not initialize! SDL_Error: %s \n", SDL_GetError());
+        throw std::runtime_error("Game controllers could not be initialized!\n");
+    }
+    m_thread = std::thread(&Gamepad::sampler_main, this);
+}
+
+Gamepad::~Gamepad()
+{
+    m_stop.store(true, std::memory_order_relaxed);
+    m_thread.join();
+    m_controller.reset();
+    SDL_QuitSubSystem(SDL_INIT_GAMECONTROLLER);
+    const uint64_t dropped = get_dropped();
+    if (dropped > 0)
+    {
+        SDL_Log("Gamepad: %llu samples dropped\n", static_cast<unsigned long long>(dropped));
+    }
+}
+
+InputBits Gamepad::consume(uint64_t time)
+{
+    int64_t axis_sum = 0;
+    int count = 0;
+    InputBits buttons = 0;
+    GamepadSample sample;
+    while (m_samples.peek(sample) && sample.time <= time)
+    {
+        m_samples.pop();
+        axis_sum += sample.axis;
+        buttons |= sample.buttons;
+        count++;
+        m_last = sample;
+    }
+    // Nothing new since the last step, the controller is as it was
+    const int axis = count > 0 ? static_cast<int>(axis_sum / count) : m_last.axis;
+    InputBits input = count > 0 ? buttons : m_last.buttons;
+
+    if (axis != 0 && (input & (InputAction::Left | InputAction::Right)) == 0)
+    {
+        input |= axis < 0 ? InputAction::Left : InputAction::Right;
+        // Rounded up, any deflection past the deadzone moves the paddle
+        const int speed = (std::abs(axis) * Paddle::full_speed + axis_max - 1) / axis_max;
+        if (speed < Paddle::full_speed)
+        {
+            input |= static_cast<InputBits>(speed << InputAction::speed_shift);
+        }
+    }
+    return input;
+}
+
+void Gamepad::pause()
+{
+    m_paused.store(true, std::memory_order_relaxed);
+}
+
+void Gamepad::resume(uint64_t time)
+{
+    GamepadSample sample;
+    while (m_samples.peek(sample) && sample.time < time)
+    {
+        m_samples.pop();
+        m_last = sample;
+    }
+    m_paused.store(false, std::memory_order_relaxed);
+}
+
+uint64_t Gamepad::get_dropped() const
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+void Gamepad::sampler_main()
+{
+    uint64_t next = RealClock::performance_now();
+    while (!m_stop.load(std::memory_order_relaxed))
+    {
+        SDL_GameControllerUpdate();
+        GamepadSample state{RealClock::performance_now(), 0, 0};
+        const bool attached = sample(state);
+        if (!m_paused.load(std::memory_order_relaxed) && !m_samples.push(state))
+        {
+            m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        next += attached ? m_period : 1'000'000'000ull / idle_hz;
+        const uint64_t now = RealClock::performance_now();
+        if (next <= now)
+        {
+            next = now;     // fell behind, do not burst the missed samples
+            continue;
+        }
+        std::this_thread::sleep_for(std::chrono::nanoseconds(next - now));
+    }
+}
+
+bool Gamepad::sample(GamepadSample& sample)
+{
+    if (m_controller && !SDL_GameControllerGetAttached(m_controller.get()))
+    {
+        SDL_Log("Gamepad detached\n");
+        m_controller.reset();
+    }
+    if (!m_controller)
+    {
+        for (int i = 0; i < SDL_NumJoysticks() && !m_controller; i++)
+        {
+            if (SDL_IsGameController(i))
+            {
+                m_controller.reset(SDL_GameControllerOpen(i));
+            }
+        }
+        if (!m_controller)
+        {
+            return false;
+        }
+        SDL_Log("Gamepad attached: %s\n", SDL_GameControllerName(m_controller.get()));
+    }
+
+    SDL_GameController* controller = m_controller.get();
+    const int raw = std::clamp<int>(SDL_GameControllerGetAxis(controller, SDL_CONTROLLER_AXIS_LEFTX), -axis_max, axis_max);
+    if (std::abs(raw) > m_deadzone)
+    {
+        const int magnitude = (std::abs(raw) - m_deadzone) * axis_max / (axis_max - m_deadzone);
+        sample.axis = raw < 0 ? -magnitude : magnitude;
+    }
+
+    const struct { SDL_GameControllerButton button; InputBits action; } mapping[] = {
+        {SDL_CONTROLLER_BUTTON_DPAD_LEFT, InputAction::Left},
+        {SDL_CONTROLLER_BUTTON_DPAD_RIGHT, InputAction::Right},
+        {SDL_CONTROLLER_BUTTON_A, InputAction::Launch},
+        {SDL_CONTROLLER_BUTTON_BACK, InputAction::Quit},
+        {SDL_CONTROLLER_BUTTON_START, InputAction::Restart},
+    };
+    for (const auto& [button, action] : mapping)
+    {
+        if (SDL_GameControllerGetButton(controller, button))
+        {
+            sample.buttons |= action;
+        }
+    }
+    return true;
+}
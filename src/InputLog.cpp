@@ -0,0 +1,480 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "SDL.h"
+
+#include "Brick.h"
+#include "GameSettings.h"
+
+#include "InputLog.h"
+
+namespace
+{
+    constexpr char magic[4] = {'A', 'R', 'K', 'I'};
+    constexpr uint32_t version = 4;     // 4: keyframes between the runs
+    constexpr size_t flush_threshold = 4096;
+    constexpr size_t max_varint_size = 10;     // LEB128 of a uint64_t
+    constexpr int settings_count = 13;
+    constexpr uint64_t max_state_size = 1 << 24;
+
+    using File = std::unique_ptr<std::FILE, decltype(&std::fclose)>;
+
+    /**
+     * Append a value to a byte buffer as it is in memory.
+     */
+    template <typename T>
+    void put(std::vector<uint8_t>& buffer, T value)
+    {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    /**
+     * Append an unsigned LEB128 varint, 7 bits per byte with the high bit marking more bytes.
+     */
+    void put_varint(std::vector<uint8_t>& buffer, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            buffer.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<uint8_t>(value));
+    }
+
+    /**
+     * Bounds checked reader over the bytes of a loaded log.
+     */
+    struct Reader
+    {
+        const uint8_t* position;
+        const uint8_t* end;
+
+        template <typename T>
+        bool get(T& value)
+        {
+            if (static_cast<size_t>(end - position) < sizeof(T))
+            {
+                return false;
+            }
+            std::memcpy(&value, position, sizeof(T));
+            position += sizeof(T);
+            return true;
+        }
+
+        bool get_varint(uint64_t& value)
+        {
+            value = 0;
+            for (int shift = 0; shift < 64 && position < end; shift += 7)
+            {
+                const uint8_t byte = *position++;
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    /**
+     * Append the delta of a state to its base: pairs of the number of unchanged bytes to skip and the number of
+     * changed bytes to copy, followed by those bytes. Unchanged bytes at the end are not encoded.
+     * A varint is never longer than the count it holds, so the delta takes at most 2 * state.size() + 1 bytes.
+     */
+    void put_delta(std::vector<uint8_t>& buffer, const std::vector<uint8_t>& base, const std::vector<uint8_t>& state)
+    {
+        size_t i = 0;
+        while (i < state.size())
+        {
+            const size_t skip_start = i;
+            while (i < state.size() && state[i] == base[i])
+            {
+                i++;
+            }
+            if (i == state.size())
+            {
+                break;
+            }
+            const size_t literal_start = i;
+            while (i < state.size() && state[i] != base[i])
+            {
+                i++;
+            }
+            put_varint(buffer, literal_start - skip_start);
+            put_varint(buffer, i - literal_start);
+            buffer.insert(buffer.end(), state.begin() + literal_start, state.begin() + i);
+        }
+    }
+
+    [[noreturn]] void invalid_log(const std::string_view path, const char* reason)
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Input log %s: %s\n", path.data(), reason);
+        throw std::runtime_error("Invalid input log!\n");
+    }
+}
+
+InputRecorder::InputRecorder(
+    const std::string_view path,
+    uint64_t seed,
+    const GameSettings& settings,
+    const std::vector<Brick>& bricks,
+    uint64_t keyframe_interval
+):
+    m_file{std::fopen(path.data(), "wb"), std::fclose},
+    m_keyframe_interval{std::max<uint64_t>(keyframe_interval, 1)}
+{
+    if (!m_file)
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Could not open %s for writing\n", path.data());
+        throw std::runtime_error("Input log could not be opened!\n");
+    }
+
+    std::vector<uint8_t> header;
+    header.insert(header.end(), magic, magic + sizeof(magic));
+    put(header, version);
+    put(header, seed);
+    const int32_t settings_values[settings_count] = {
+        settings.screen_width, settings.screen_height,
+        settings.paddle_width, settings.paddle_height, settings.paddle_speed, settings.paddle_offset,
+        settings.ball_size, settings.ball_speed, settings.num_of_balls,
+        settings.fps_limit, settings.physics_hz, settings.hud_hz, settings.telemetry_hz
+    };
+    for (int32_t value : settings_values)
+    {
+        put(header, value);
+    }
+    put(header, static_cast<uint32_t>(bricks.size()));
+    for (const auto& brick : bricks)
+    {
+        const SDL_Color color = brick.get_color();
+        put(header, static_cast<int32_t>(brick.left()));
+        put(header, static_cast<int32_t>(brick.top()));
+        put(header, static_cast<int32_t>(brick.right() - brick.left()));
+        put(header, static_cast<int32_t>(brick.bottom() - brick.top()));
+        put(header, static_cast<int32_t>(brick.get_points()));
+        header.insert(header.end(), {color.r, color.g, color.b, color.a});
+    }
+    if (std::fwrite(header.data(), 1, header.size(), m_file.get()) != header.size())
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Could not write the input log %s\n", path.data());
+        throw std::runtime_error("Input log could not be written!\n");
+    }
+
+    m_pending_capacity = flush_threshold * 2;
+    m_pending.reserve(m_pending_capacity);
+    m_writer_thread = std::thread(&InputRecorder::writer_main, this);
+}
+
+InputRecorder::~InputRecorder()
+{
+    emit_run();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_writer_thread.join();
+    SDL_Log("Input log: %llu ticks, %ld bytes\n", static_cast<unsigned long long>(m_ticks), std::ftell(m_file.get()));
+}
+
+void InputRecorder::record(InputBits input)
+{
+    m_ticks++;
+    if (m_run > 0 && input == m_current)
+    {
+        m_run++;
+        return;
+    }
+    emit_run();
+    m_current = input;
+    m_run = 1;
+}
+
+bool InputRecorder::keyframe_due() const
+{
+    return m_ticks >= m_next_keyframe;
+}
+
+void InputRecorder::keyframe(const std::vector<uint8_t>& state)
+{
+    emit_run();
+    if (m_keyframe.size() != state.size())
+    {
+        // Only on the first keyframe, the state keeps its size: size the buffers for the largest delta so the
+        // keyframes of the game loop do not allocate
+        m_keyframe.assign(state.size(), 0);
+        m_delta.reserve(2 * state.size() + 1);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending_capacity = std::max(m_pending_capacity, flush_threshold * 2 + 3 * max_varint_size + m_delta.capacity());
+        m_pending.reserve(m_pending_capacity);
+    }
+    m_delta.clear();
+    put_delta(m_delta, m_keyframe, state);
+    m_keyframe = state;
+    m_next_keyframe = m_ticks + m_keyframe_interval;
+
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        put_varint(m_pending, 0);
+        put_varint(m_pending, state.size());
+        put_varint(m_pending, m_delta.size());
+        m_pending.insert(m_pending.end(), m_delta.begin(), m_delta.end());
+        wake = m_pending.size() >= flush_threshold;
+    }
+    if (wake)
+    {
+        m_cv.notify_all();
+    }
+}
+
+uint64_t InputRecorder::get_tick_count() const
+{
+    return m_ticks;
+}
+
+void InputRecorder::emit_run()
+{
+    if (m_run == 0)
+    {
+        return;
+    }
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        put_varint(m_pending, m_run);
+        m_pending.push_back(m_current);
+        wake = m_pending.size() >= flush_threshold;
+    }
+    m_run = 0;
+    if (wake)
+    {
+        m_cv.notify_all();
+    }
+}
+
+void InputRecorder::writer_main()
+{
+    std::vector<uint8_t> writing;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_cv.wait_for(lock, std::chrono::seconds(1), [this] { return m_stop || m_pending.size() >= flush_threshold; });
+        // The buffers swap places, the one handed to the game thread must have room for the records to come
+        writing.reserve(m_pending_capacity);
+        writing.swap(m_pending);
+        const bool stop = m_stop;
+        lock.unlock();
+
+        if (!writing.empty())
+        {
+            if (std::fwrite(writing.data(), 1, writing.size(), m_file.get()) != writing.size())
+            {
+                SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Failed to write the input log\n");
+            }
+            std::fflush(m_file.get());
+            writing.clear();
+        }
+        if (stop)
+        {
+            return;
+        }
+        lock.lock();
+    }
+}
+
+InputPlayback::InputPlayback(const std::string_view path)
+{
+    File file{std::fopen(path.data(), "rb"), std::fclose};
+    if (!file)
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Could not open %s\n", path.data());
+        throw std::runtime_error("Input log could not be opened!\n");
+    }
+
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[4096];
+    size_t read = 0;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file.get())) > 0)
+    {
+        bytes.insert(bytes.end(), chunk, chunk + read);
+    }
+
+    Reader reader{bytes.data(), bytes.data() + bytes.size()};
+    char file_magic[4] = {0};
+    uint32_t file_version = 0;
+    if (!reader.get(file_magic) || std::memcmp(file_magic, magic, sizeof(magic)) != 0)
+    {
+        invalid_log(path, "not an input log");
+    }
+    if (!reader.get(file_version) || file_version != version)
+    {
+        invalid_log(path, "unsupported version");
+    }
+
+    uint32_t brick_count = 0;
+    if (!reader.get(m_seed) || !reader.get(m_settings) || !reader.get(brick_count))
+    {
+        invalid_log(path, "truncated header");
+    }
+    for (int32_t value : m_settings)
+    {
+        if (value <= 0)
+        {
+            invalid_log(path, "invalid game settings");
+        }
+    }
+    // Validate the brick count against the file size before allocating for it
+    constexpr size_t brick_size = 5 * sizeof(int32_t) + 4;
+    if (brick_count > static_cast<size_t>(reader.end - reader.position) / brick_size)
+    {
+        invalid_log(path, "truncated bricks");
+    }
+    m_bricks.reserve(brick_count);
+    for (uint32_t i = 0; i < brick_count; i++)
+    {
+        int32_t geometry[5] = {};
+        uint8_t color[4] = {};
+        reader.get(geometry);
+        reader.get(color);
+        m_bricks.emplace_back(
+            geometry[0], geometry[1], geometry[2], geometry[3], geometry[4],
+            SDL_Color{color[0], color[1], color[2], color[3]}
+        );
+    }
+
+    std::vector<uint8_t> state;
+    while (reader.position < reader.end)
+    {
+        Run run{m_tick_count, 0, 0};
+        if (!reader.get_varint(run.ticks))
+        {
+            invalid_log(path, "corrupted input");
+        }
+        if (run.ticks > 0)
+        {
+            if (!reader.get(run.input))
+            {
+                invalid_log(path, "corrupted input");
+            }
+            m_tick_count += run.ticks;
+            m_runs.push_back(run);
+            continue;
+        }
+
+        // Keyframe, patch the previous state with its delta
+        uint64_t state_size = 0;
+        uint64_t delta_size = 0;
+        if (!reader.get_varint(state_size) || !reader.get_varint(delta_size)
+            || delta_size > static_cast<uint64_t>(reader.end - reader.position)
+            || state_size > max_state_size)
+        {
+            invalid_log(path, "corrupted keyframe");
+        }
+        if (state.size() != state_size)
+        {
+            state.assign(state_size, 0);
+        }
+        Reader delta{reader.position, reader.position + delta_size};
+        size_t offset = 0;
+        while (delta.position < delta.end)
+        {
+            uint64_t skip = 0;
+            uint64_t literal = 0;
+            if (!delta.get_varint(skip) || !delta.get_varint(literal)
+                || literal > static_cast<uint64_t>(delta.end - delta.position)
+                || skip > state.size() - offset
+                || literal > state.size() - offset - skip)
+            {
+                invalid_log(path, "corrupted keyframe");
+            }
+            offset += skip;
+            std::memcpy(state.data() + offset, delta.position, literal);
+            offset += literal;
+            delta.position += literal;
+        }
+        reader.position += delta_size;
+        m_keyframes.push_back(Keyframe{m_tick_count, state});
+    }
+}
+
+bool InputPlayback::next(InputBits& input)
+{
+    if (m_run_index >= m_runs.size())
+    {
+        return false;
+    }
+    input = m_runs[m_run_index].input;
+    if (++m_run_position == m_runs[m_run_index].ticks)
+    {
+        m_run_index++;
+        m_run_position = 0;
+    }
+    return true;
+}
+
+const InputPlayback::Keyframe* InputPlayback::find_keyframe(uint64_t tick) const
+{
+    const auto after = std::upper_bound(
+        m_keyframes.begin(), m_keyframes.end(), tick,
+        [](uint64_t value, const Keyframe& keyframe) { return value < keyframe.tick; }
+    );
+    return after == m_keyframes.begin() ? nullptr : &*(after - 1);
+}
+
+void InputPlayback::seek(uint64_t tick)
+{
+    const auto after = std::upper_bound(
+        m_runs.begin(), m_runs.end(), tick,
+        [](uint64_t value, const Run& run) { return value < run.start; }
+    );
+    if (tick >= m_tick_count || after == m_runs.begin())
+    {
+        m_run_index = tick >= m_tick_count ? m_runs.size() : 0;
+        m_run_position = 0;
+        return;
+    }
+    m_run_index = static_cast<size_t>(after - m_runs.begin()) - 1;
+    m_run_position = tick - m_runs[m_run_index].start;
+}
+
+uint64_t InputPlayback::get_position() const
+{
+    return m_run_index < m_runs.size() ? m_runs[m_run_index].start + m_run_position : m_tick_count;
+}
+
+size_t InputPlayback::get_tick_count() const
+{
+    return static_cast<size_t>(m_tick_count);
+}
+
+uint64_t InputPlayback::get_seed() const
+{
+    return m_seed;
+}
+
+GameSettings InputPlayback::get_settings() const
+{
+    return GameSettings{
+        m_settings[0], m_settings[1],
+        m_settings[2], m_settings[3], m_settings[4], m_settings[5],
+        m_settings[6], m_settings[7], m_settings[8],
+        m_settings[9], m_settings[10], m_settings[11], m_settings[12]
+    };
+}
+
+const std::vector<Brick>& InputPlayback::get_bricks() const
+{
+    return m_bricks;
+}
@@ -0,0 +1,55 @@
+#include <cstdint>
+
+#include "InputLog.h"
+
+#include "InputQueue.h"
+
+void InputQueue::push(uint64_t time, InputBits action, bool pressed)
+{
+    if (m_size == capacity)
+    {
+        apply_front();
+    }
+    if (m_size > 0)
+    {
+        const KeyEvent& last = m_events[(m_head + m_size - 1) % capacity];
+        if (time < last.time)
+        {
+            time = last.time;
+        }
+    }
+    m_events[(m_head + m_size) % capacity] = KeyEvent{time, action, pressed};
+    m_size++;
+}
+
+InputBits InputQueue::consume(uint64_t time)
+{
+    while (m_size > 0 && m_events[m_head].time <= time)
+    {
+        apply_front();
+    }
+    const InputBits input = m_held | m_latched;
+    m_latched = 0;
+    return input;
+}
+
+int InputQueue::size() const
+{
+    return m_size;
+}
+
+void InputQueue::apply_front()
+{
+    const KeyEvent& event = m_events[m_head];
+    if (event.pressed)
+    {
+        m_held |= event.action;
+        m_latched |= event.action;
+    }
+    else
+    {
+        m_held &= ~event.action;
+    }
+    m_head = (m_head + 1) % capacity;
+    m_size--;
+}
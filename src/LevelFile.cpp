@@ -0,0 +1,61 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "SDL.h"
+
+#include "LevelFile.h"
+
+namespace
+{
+    using File = std::unique_ptr<std::FILE, decltype(&std::fclose)>;
+}
+
+bool is_level_file(const std::string_view path)
+{
+    File file{std::fopen(path.data(), "rb"), std::fclose};
+    char magic[sizeof(level_magic)] = {};
+    return file
+        && std::fread(magic, 1, sizeof(magic), file.get()) == sizeof(magic)
+        && std::memcmp(magic, level_magic, sizeof(magic)) == 0;
+}
+
+void write_level_file(
+    const std::string_view path,
+    uint32_t width,
+    uint32_t height,
+    const std::vector<SDL_Color>& palette,
+    const std::vector<LevelFileBrick>& bricks
+)
+{
+    LevelFileHeader header{};
+    std::memcpy(header.magic, level_magic, sizeof(level_magic));
+    header.version = level_version;
+    header.width = width;
+    header.height = height;
+    header.palette_size = static_cast<uint32_t>(palette.size());
+    header.brick_count = static_cast<uint32_t>(bricks.size());
+
+    File file{std::fopen(path.data(), "wb"), std::fclose};
+    if (!file)
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Could not open %s for writing\n", path.data());
+        throw std::runtime_error("Level could not be written!\n");
+    }
+    bool written = std::fwrite(&header, sizeof(header), 1, file.get()) == 1;
+    for (const SDL_Color& color : palette)
+    {
+        const uint8_t rgba[4] = {color.r, color.g, color.b, color.a};
+        written = written && std::fwrite(rgba, sizeof(rgba), 1, file.get()) == 1;
+    }
+    written = written && std::fwrite(bricks.data(), sizeof(LevelFileBrick), bricks.size(), file.get()) == bricks.size();
+    if (!written || std::fflush(file.get()) != 0)
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Could not write the level %s\n", path.data());
+        throw std::runtime_error("Level could not be written!\n");
+    }
+}
@@ -0,0 +1,130 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "SDL.h"
+
+#include "Bricks.h"
+#include "BinaryLevelLayout.h"
+#include "TextLayout.h"
+#include "LevelFile.h"
+
+#include "LevelPack.h"
+
+LoadedLevel load_level(const std::string_view path)
+{
+    if (is_level_file(path))
+    {
+        auto level = std::make_unique<BinaryLevelLayout>(path);
+        const int width = level->get_width();
+        const int height = level->get_height();
+        return LoadedLevel{std::move(level), width, height};
+    }
+    auto level = std::make_unique<TextLayout>(path);
+    const int width = level->get_width();
+    const int height = level->get_height();
+    return LoadedLevel{std::move(level), width, height};
+}
+
+LevelPack::LevelPack(const std::string_view path)
+{
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file{std::fopen(path.data(), "r"), std::fclose};
+    if (!file)
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Could not open %s\n", path.data());
+        throw std::runtime_error("Level pack could not be opened!\n");
+    }
+
+    const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    char line[1024];
+    while (std::fgets(line, sizeof(line), file.get()))
+    {
+        std::string_view text(line, std::strcspn(line, "#\r\n"));
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+        {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t'))
+        {
+            text.remove_suffix(1);
+        }
+        if (!text.empty())
+        {
+            m_paths.push_back((directory / std::filesystem::path(text)).string());
+        }
+    }
+    if (m_paths.empty())
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Level pack %s lists no levels\n", path.data());
+        throw std::runtime_error("Invalid level pack!\n");
+    }
+}
+
+LevelPack::~LevelPack()
+{
+    if (m_prefetch.valid())
+    {
+        m_prefetch.wait();
+    }
+}
+
+const std::string& LevelPack::get_path(size_t index) const
+{
+    return m_paths.at(index);
+}
+
+size_t LevelPack::size() const
+{
+    return m_paths.size();
+}
+
+size_t LevelPack::get_current() const
+{
+    return m_current;
+}
+
+void LevelPack::prefetch(size_t index)
+{
+    if (index >= m_paths.size() || (m_prefetch.valid() && m_prefetched == index))
+    {
+        return;
+    }
+    if (m_prefetch.valid())
+    {
+        m_prefetch.wait();      // the future of std::async would block in its destructor anyway
+    }
+    m_prefetched = index;
+    m_prefetch = std::async(std::launch::async, &LevelPack::load_bricks, m_paths[index]);
+}
+
+LevelBricks LevelPack::take(size_t index)
+{
+    LevelBricks level;
+    if (m_prefetch.valid() && m_prefetched == index)
+    {
+        if (m_prefetch.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            SDL_Log("Level %zu is still loading, waiting for it\n", index + 1);
+        }
+        level = m_prefetch.get();      // rethrows a failed load
+    }
+    else
+    {
+        level = load_bricks(m_paths.at(index));
+    }
+    m_current = index;
+    return level;
+}
+
+LevelBricks LevelPack::load_bricks(const std::string& path)
+{
+    LoadedLevel level = load_level(path);
+    return LevelBricks{std::make_unique<Bricks>(*level.layout), level.width, level.height};
+}
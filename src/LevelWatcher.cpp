@@ -0,0 +1,190 @@
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "SDL.h"
+
+#include "Bricks.h"
+#include "LevelPack.h"
+
+#include "LevelWatcher.h"
+
+namespace
+{
+    constexpr int settle_ms = 20;       // quiet time before a changed level is loaded, a save may touch it repeatedly
+    constexpr int max_settle_rounds = 5;
+}
+
+LevelWatcher::LevelWatcher(const std::string_view path)
+{
+    m_event_type = SDL_RegisterEvents(1);
+    if (m_event_type == static_cast<uint32_t>(-1))
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Could not register the level reload event! SDL_Error: %s\n", SDL_GetError());
+        throw std::runtime_error("Level watcher could not be created!\n");
+    }
+#ifdef __linux__
+    m_inotify = inotify_init1(IN_CLOEXEC);
+    m_wake = eventfd(0, EFD_CLOEXEC);
+    if (m_inotify < 0 || m_wake < 0)
+    {
+        if (m_inotify >= 0)
+        {
+            close(m_inotify);
+        }
+        if (m_wake >= 0)
+        {
+            close(m_wake);
+        }
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Could not set up inotify for %s\n", path.data());
+        throw std::runtime_error("Level watcher could not be created!\n");
+    }
+    watch(path);
+    m_thread = std::thread(&LevelWatcher::watcher_main, this);
+#else
+    watch(path);
+    SDL_Log("Reloading changed levels needs inotify, not supported on this platform\n");
+#endif
+}
+
+LevelWatcher::~LevelWatcher()
+{
+#ifdef __linux__
+    const uint64_t stop = 1;
+    if (write(m_wake, &stop, sizeof(stop)) != sizeof(stop))
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Could not stop the level watcher\n");
+    }
+    m_thread.join();
+    close(m_inotify);
+    close(m_wake);
+#endif
+}
+
+void LevelWatcher::watch(const std::string_view path)
+{
+    const std::filesystem::path file(path);
+    std::lock_guard lock(m_mutex);
+    m_directory = file.has_parent_path() ? file.parent_path().string() : std::string(".");
+    m_name = file.filename().string();
+#ifdef __linux__
+    // Editors often save into a new file renamed over the old one, only the directory sees that
+    const int watch = inotify_add_watch(m_inotify, m_directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (watch < 0)
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Could not watch %s, changes of %s are not reloaded\n", m_directory.c_str(), m_name.c_str());
+    }
+    if (m_watch >= 0 && m_watch != watch)
+    {
+        inotify_rm_watch(m_inotify, m_watch);
+    }
+    m_watch = watch;
+#endif
+    SDL_Log("Watching %s for changes\n", std::string(path).c_str());
+}
+
+uint32_t LevelWatcher::get_event_type() const
+{
+    return m_event_type;
+}
+
+LevelBricks LevelWatcher::take()
+{
+    std::lock_guard lock(m_mutex);
+    return std::exchange(m_ready, LevelBricks{});
+}
+
+#ifdef __linux__
+
+void LevelWatcher::watcher_main()
+{
+    alignas(inotify_event) char buffer[4096];
+    pollfd fds[2] = {{m_inotify, POLLIN, 0}, {m_wake, POLLIN, 0}};
+    while (true)
+    {
+        if (poll(fds, 2, -1) < 0)
+        {
+            continue;   // interrupted
+        }
+        if (fds[1].revents != 0)
+        {
+            return;
+        }
+
+        // Drain the events, then wait for the save to settle before loading
+        bool changed = false;
+        int rounds = 0;
+        do
+        {
+            const ssize_t length = read(m_inotify, buffer, sizeof(buffer));
+            std::lock_guard lock(m_mutex);
+            for (ssize_t offset = 0; offset < length; )
+            {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                if (event->wd == m_watch && event->len > 0 && m_name == event->name)
+                {
+                    changed = true;
+                }
+                offset += sizeof(inotify_event) + event->len;
+            }
+        } while (changed && ++rounds < max_settle_rounds && poll(fds, 1, settle_ms) > 0);
+
+        if (changed)
+        {
+            rebuild();
+        }
+    }
+}
+
+#else
+
+void LevelWatcher::watcher_main()
+{
+}
+
+#endif
+
+void LevelWatcher::rebuild()
+{
+    std::string path;
+    {
+        std::lock_guard lock(m_mutex);
+        path = (std::filesystem::path(m_directory) / m_name).string();
+    }
+    const auto start = std::chrono::steady_clock::now();
+    LevelBricks bricks;
+    try
+    {
+        LoadedLevel level = load_level(path);
+        bricks = LevelBricks{std::make_unique<Bricks>(*level.layout), level.width, level.height};
+    }
+    catch (const std::runtime_error&)
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Changed level %s not loaded, keeping the current bricks\n", path.c_str());
+        return;
+    }
+    const auto took = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    SDL_Log("Reloaded %s in %lld us\n", path.c_str(), static_cast<long long>(took.count()));
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_ready = std::move(bricks);
+    }
+    SDL_Event event{};
+    event.type = m_event_type;
+    SDL_PushEvent(&event);
+}
@@ -0,0 +1,126 @@
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "SDL.h"
+
+#include "MappedFile.h"
+
+namespace
+{
+    [[noreturn]] void map_failed(const std::string_view path)
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Could not map %s\n", path.data());
+        throw std::runtime_error("File could not be mapped!\n");
+    }
+}
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string_view path)
+{
+    HANDLE file = CreateFileA(path.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        map_failed(path);
+    }
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        map_failed(path);
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size == 0)
+    {
+        CloseHandle(file);
+        return;
+    }
+    // The mapping object keeps the file open, the handle is not needed anymore
+    m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!m_mapping)
+    {
+        map_failed(path);
+    }
+    m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_data)
+    {
+        CloseHandle(m_mapping);
+        map_failed(path);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping)
+    {
+        CloseHandle(m_mapping);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string_view path)
+{
+    const int file = open(path.data(), O_RDONLY);
+    if (file < 0)
+    {
+        map_failed(path);
+    }
+    struct stat info{};
+    if (fstat(file, &info) != 0)
+    {
+        close(file);
+        map_failed(path);
+    }
+    m_size = static_cast<size_t>(info.st_size);
+    if (m_size == 0)
+    {
+        close(file);
+        return;
+    }
+    // The mapping keeps its own reference to the file
+    void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED)
+    {
+        map_failed(path);
+    }
+    m_data = static_cast<const uint8_t*>(data);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+    {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+}
+
+#endif
+
+const uint8_t* MappedFile::data() const
+{
+    return m_data;
+}
+
+size_t MappedFile::size() const
+{
+    return m_size;
+}
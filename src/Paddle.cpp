@@ -4,9 +4,11 @@
 
 #include "Paddle.h"
 
-Paddle::Paddle(int x, int y, int paddle_width, int paddle_height, int paddle_speed):
+Paddle::Paddle(int x, int y, int paddle_width, int paddle_height, int paddle_speed, int speed_rate, int tick_rate):
     m_rect{.x = x, .y = y, .w = paddle_width, .h = paddle_height}, 
     m_paddle_speed{paddle_speed},
+    m_speed_rate{speed_rate},
+    m_tick_rate{tick_rate},
     m_original_rect{.x = x, .y = y, .w = paddle_width, .h = paddle_height}
 {
 }
@@ -18,29 +20,56 @@ SDL_Rect* Paddle::get()
 
 void Paddle::draw(Screen& screen, SDL_Color color)
 {
-    SDL_SetRenderDrawColor(screen.get_renderer_ptr_raw(), color.r, color.g, color.b, color.a);
-    SDL_RenderFillRect(screen.get_renderer_ptr_raw(), &m_rect);
+    screen.fill_rect(screen.to_screen(m_rect), color, RenderLayer::Entities);
 }
 
-void Paddle::move_left(const int& edge)
+void Paddle::move_left(const int& edge, int speed)
 {
     if (m_rect.x > edge)
     {
-        m_rect.x -= m_paddle_speed;
+        m_rect.x -= step(speed);
     }
 }
 
-void Paddle::move_right(const int& edge)
+void Paddle::move_right(const int& edge, int speed)
 {
     if (m_rect.x + m_rect.w < edge)
     {
-        m_rect.x += m_paddle_speed;
+        m_rect.x += step(speed);
     }
 }
 
 void Paddle::reset()
 {
     m_rect = m_original_rect;
+    m_step_remainder = 0;
+}
+
+void Paddle::set_origin(int x, int y)
+{
+    m_original_rect.x = x;
+    m_original_rect.y = y;
+    reset();
+}
+
+Paddle::State Paddle::get_state() const
+{
+    return State{m_rect.x, m_rect.y, m_step_remainder};
+}
+
+void Paddle::set_state(const State& state)
+{
+    m_rect.x = state.x;
+    m_rect.y = state.y;
+    m_step_remainder = state.step_remainder;
+}
+
+int Paddle::step(int speed)
+{
+    m_step_remainder += m_paddle_speed * m_speed_rate * speed;
+    const int pixels = m_step_remainder / (m_tick_rate * full_speed);
+    m_step_remainder -= pixels * m_tick_rate * full_speed;
+    return pixels;
 }
 
 int Paddle::left() const
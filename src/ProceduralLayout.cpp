@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "SDL.h"
+
+#include "Brick.h"
+#include "BricksLayout.h"
+
+#include "ProceduralLayout.h"
+
+namespace
+{
+    constexpr uint64_t pattern_salt = 0x5851F42D4C957F2D;
+    constexpr uint64_t detail_salt = 0x14057B7EF767814F;
+    constexpr uint64_t color_salt = 0x2545F4914F6CDD1D;
+
+    /**
+     * Colors and points of the bricks, the noise picks an entry per brick.
+     */
+    constexpr struct { SDL_Color color; int points; } palette[] = {
+        {{255, 0, 0, 255}, 50},
+        {{255, 128, 0, 255}, 40},
+        {{255, 255, 0, 255}, 30},
+        {{0, 255, 0, 255}, 20},
+        {{0, 128, 255, 255}, 10},
+    };
+    constexpr int palette_size = sizeof(palette) / sizeof(palette[0]);
+
+    /**
+     * splitmix64 finalizer, a cheap well mixed 64 bit hash.
+     */
+    uint64_t splitmix64(uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EB;
+        return x ^ (x >> 31);
+    }
+
+    /**
+     * Random value of a lattice point of the noise, 0 to 65535.
+     */
+    int64_t lattice(uint64_t seed, int x, int y)
+    {
+        return static_cast<int64_t>(splitmix64(seed + (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(y))) >> 48);
+    }
+
+    /**
+     * Smoothstep 3t^2 - 2t^3 in 16.16 fixed point, t from 0 to 65536.
+     */
+    int64_t smooth(int64_t t)
+    {
+        return (t * t * (3 * 65536 - 2 * t)) >> 32;
+    }
+
+    /**
+     * Value noise of a cell, the lattice points are scale cells apart. 0 to 65535.
+     */
+    int64_t value_noise(uint64_t seed, int x, int y, int scale)
+    {
+        const int lattice_x = x / scale;
+        const int lattice_y = y / scale;
+        const int64_t fraction_x = smooth(static_cast<int64_t>(x % scale) * 65536 / scale);
+        const int64_t fraction_y = smooth(static_cast<int64_t>(y % scale) * 65536 / scale);
+        const int64_t a = lattice(seed, lattice_x, lattice_y);
+        const int64_t b = lattice(seed, lattice_x + 1, lattice_y);
+        const int64_t c = lattice(seed, lattice_x, lattice_y + 1);
+        const int64_t d = lattice(seed, lattice_x + 1, lattice_y + 1);
+        const int64_t top = a + (((b - a) * fraction_x) >> 16);
+        const int64_t bottom = c + (((d - c) * fraction_x) >> 16);
+        return top + (((bottom - top) * fraction_y) >> 16);
+    }
+
+    /**
+     * A cell of the fundamental region of the symmetry, standing for weight cells of the grid.
+     */
+    struct Cell
+    {
+        int64_t value;
+        int col;
+        int row;
+        int weight;
+    };
+}
+
+ProceduralLayout::ProceduralLayout(const ProceduralLayoutSettings& settings):
+    m_settings(settings)
+{
+}
+
+std::pmr::vector<Brick> ProceduralLayout::create_bricks(std::pmr::memory_resource* arena)
+{
+    const int rows = std::max(m_settings.brick_rows, 0);
+    const int cols = std::max(m_settings.brick_cols, 0);
+    const int feature = std::max(m_settings.feature_size, 1);
+    const bool mirror_cols = m_settings.symmetry != ProceduralSymmetry::None;
+    const bool mirror_rows = m_settings.symmetry == ProceduralSymmetry::Quad;
+    const int region_cols = mirror_cols ? (cols + 1) / 2 : cols;
+    const int region_rows = mirror_rows ? (rows + 1) / 2 : rows;
+    const uint64_t seed = splitmix64(m_settings.seed);
+
+    // Coarse blobs plus finer detail at half the size
+    std::pmr::vector<Cell> cells(arena);
+    cells.reserve(static_cast<size_t>(region_cols) * region_rows);
+    for (int row = 0; row < region_rows; row++)
+    {
+        for (int col = 0; col < region_cols; col++)
+        {
+            const int64_t value = 2 * value_noise(seed ^ pattern_salt, col, row, feature)
+                + value_noise(seed ^ detail_salt, col, row, std::max(feature / 2, 1));
+            const int weight = (mirror_cols && col != cols - 1 - col ? 2 : 1) * (mirror_rows && row != rows - 1 - row ? 2 : 1);
+            cells.push_back(Cell{value, col, row, weight});
+        }
+    }
+    std::sort(cells.begin(), cells.end(), [](const Cell& a, const Cell& b) {
+        return a.value != b.value ? a.value > b.value : (a.row != b.row ? a.row < b.row : a.col < b.col);
+    });
+
+    // Fill the highest cells with their mirror images until the density is met
+    const int target = (rows * cols * std::clamp(m_settings.density, 0, 100) + 50) / 100;
+    std::pmr::vector<uint8_t> filled(static_cast<size_t>(rows) * cols, 0, arena);
+    int count = 0;
+    for (const Cell& cell : cells)
+    {
+        if (count + cell.weight > target)
+        {
+            continue;
+        }
+        count += cell.weight;
+        const int mirrored_col = mirror_cols ? cols - 1 - cell.col : cell.col;
+        const int mirrored_row = mirror_rows ? rows - 1 - cell.row : cell.row;
+        filled[cell.row * cols + cell.col] = 1;
+        filled[cell.row * cols + mirrored_col] = 1;
+        filled[mirrored_row * cols + cell.col] = 1;
+        filled[mirrored_row * cols + mirrored_col] = 1;
+    }
+
+    std::pmr::vector<Brick> bricks(arena);
+    bricks.reserve(count);
+    for (int row = 0; row < rows; row++)
+    {
+        for (int col = 0; col < cols; col++)
+        {
+            if (!filled[row * cols + col])
+            {
+                continue;
+            }
+            // The color comes from the folded cell too, mirrored bricks match
+            const int region_col = mirror_cols ? std::min(col, cols - 1 - col) : col;
+            const int region_row = mirror_rows ? std::min(row, rows - 1 - row) : row;
+            const int index = static_cast<int>(value_noise(seed ^ color_salt, region_col, region_row, feature * 2) * palette_size >> 16);
+            bricks.emplace_back(
+                col * m_settings.brick_width,
+                (m_settings.starting_row + row) * m_settings.brick_height,
+                m_settings.brick_width - m_settings.brick_spacing,
+                m_settings.brick_height - m_settings.brick_spacing,
+                palette[index].points,
+                SDL_Color(palette[index].color)
+            );
+        }
+    }
+    return bricks;
+}
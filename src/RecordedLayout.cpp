@@ -0,0 +1,18 @@
+#include <memory_resource>
+#include <vector>
+
+#include "Brick.h"
+#include "BricksLayout.h"
+
+#include "RecordedLayout.h"
+
+
+RecordedLayout::RecordedLayout(const std::vector<Brick>& bricks):
+    m_bricks(bricks)
+{
+}
+
+std::pmr::vector<Brick> RecordedLayout::create_bricks(std::pmr::memory_resource* arena)
+{
+    return std::pmr::vector<Brick>(m_bricks.begin(), m_bricks.end(), arena);
+}
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#include "SDL.h"
+
+#include "RenderCommands.h"
+
+namespace
+{
+    uint32_t pack_color(SDL_Color color)
+    {
+        return (uint32_t(color.r) << 24) | (uint32_t(color.g) << 16) | (uint32_t(color.b) << 8) | uint32_t(color.a);
+    }
+
+    bool same_color(SDL_Color a, SDL_Color b)
+    {
+        return pack_color(a) == pack_color(b);
+    }
+
+    const void* source(const RenderCommand& command)
+    {
+        return command.texture ? static_cast<const void*>(command.texture) : static_cast<const void*>(command.surface);
+    }
+}
+
+RenderCommandList::RenderCommandList(std::pmr::memory_resource* arena, size_t initial_capacity):
+    m_arena{arena},
+    m_commands{arena},
+    m_batch{arena},
+    m_capacity{initial_capacity}
+{
+    reset();
+}
+
+void RenderCommandList::reset()
+{
+    // The storage went with the arena reset, giving it back to the arena does nothing
+    m_capacity = std::max(m_capacity, m_commands.capacity());
+    m_commands = std::pmr::vector<RenderCommand>(m_arena);
+    m_batch = std::pmr::vector<SDL_Rect>(m_arena);
+    m_commands.reserve(m_capacity);
+}
+
+RenderCommand& RenderCommandList::push()
+{
+    RenderCommand& command = m_commands.emplace_back();
+    command.sequence = static_cast<uint32_t>(m_commands.size() - 1);
+    return command;
+}
+
+void RenderCommandList::fill_rect(const SDL_Rect& dest, SDL_Color color, RenderLayer layer)
+{
+    RenderCommand& command = push();
+    command.dest = dest;
+    command.source = SDL_Rect{0, 0, 0, 0};
+    command.texture = nullptr;
+    command.surface = nullptr;
+    command.color = color;
+    command.layer = layer;
+}
+
+void RenderCommandList::textured_quad(SDL_Texture* texture, SDL_Surface* surface, const SDL_Rect& dest, RenderLayer layer, const SDL_Rect& source)
+{
+    if (!texture && !surface)
+    {
+        return;
+    }
+    RenderCommand& command = push();
+    command.dest = dest;
+    command.source = source;
+    command.texture = texture;
+    command.surface = surface;
+    command.color = SDL_Color{0, 0, 0, 0};
+    command.layer = layer;
+}
+
+void RenderCommandList::sort()
+{
+    std::sort(
+        m_commands.begin(),
+        m_commands.end(),
+        [](const RenderCommand& a, const RenderCommand& b)
+        {
+            if (a.layer != b.layer) return a.layer < b.layer;
+            if (source(a) != source(b)) return std::less<const void*>{}(source(a), source(b));
+            uint32_t color_a = pack_color(a.color);
+            uint32_t color_b = pack_color(b.color);
+            if (color_a != color_b) return color_a < color_b;
+            return a.sequence < b.sequence;
+        }
+    );
+}
+
+RenderStats RenderCommandList::submit(SDL_Renderer* renderer, SDL_Color current_color)
+{
+    RenderStats stats;
+    const size_t size = m_commands.size();
+    stats.commands = static_cast<int>(size);
+    sort();
+    m_batch.resize(size);
+
+    SDL_Texture* current_texture = nullptr;
+    size_t i = 0;
+    while (i < size)
+    {
+        const RenderCommand& command = m_commands[i];
+        if (!command.is_fill())
+        {
+            if (!command.texture)   // software only quad
+            {
+                i++;
+                continue;
+            }
+            if (command.texture != current_texture)
+            {
+                current_texture = command.texture;
+                stats.texture_changes++;
+            }
+            const SDL_Rect* source = command.source.w > 0 ? &command.source : nullptr;
+            if (SDL_RenderCopy(renderer, command.texture, source, &command.dest) != 0)
+            {
+                SDL_Log("SDL_RenderCopy failed %s \n", SDL_GetError());
+                throw std::runtime_error("SDL_RenderCopy failed");
+            }
+            stats.draw_calls++;
+            i++;
+            continue;
+        }
+
+        if (!same_color(command.color, current_color))
+        {
+            if (SDL_SetRenderDrawColor(renderer, command.color.r, command.color.g, command.color.b, command.color.a) != 0)
+            {
+                SDL_Log("SDL_SetRenderDrawColor failed %s \n", SDL_GetError());
+                throw std::runtime_error("SDL_SetRenderDrawColor failed");
+            }
+            current_color = command.color;
+            stats.color_changes++;
+        }
+
+        // Batch the run of fill rects sharing the layer and the color into a single draw call
+        size_t run = 0;
+        while (i < size
+            && m_commands[i].is_fill()
+            && m_commands[i].layer == command.layer
+            && same_color(m_commands[i].color, current_color))
+        {
+            m_batch[run++] = m_commands[i].dest;
+            i++;
+        }
+        if (SDL_RenderFillRects(renderer, m_batch.data(), static_cast<int>(run)) != 0)
+        {
+            SDL_Log("SDL_RenderFillRects failed %s \n", SDL_GetError());
+            throw std::runtime_error("SDL_RenderFillRects failed");
+        }
+        stats.draw_calls++;
+    }
+    return stats;
+}
+
+const RenderCommand* RenderCommandList::data() const
+{
+    return m_commands.data();
+}
+
+size_t RenderCommandList::size() const
+{
+    return m_commands.size();
+}
+
+size_t RenderCommandList::capacity() const
+{
+    return m_commands.capacity();
+}
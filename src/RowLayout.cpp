@@ -1,7 +1,9 @@
+#include <memory_resource>
 #include <vector>
 
 #include "Brick.h"
 #include "BricksLayout.h"
+#include "StaticLayout.h"
 
 #include "RowLayout.h"
 
@@ -11,34 +13,16 @@ RowLayout::RowLayout(const RowLayoutSettings& settings):
 {
 }
 
-std::vector<Brick> RowLayout::create_bricks()
+std::pmr::vector<Brick> RowLayout::create_bricks(std::pmr::memory_resource* arena)
 {
-    std::vector<Brick> bricks;
+    std::pmr::vector<Brick> bricks(arena);
+    bricks.reserve(static_cast<size_t>(m_settings.brick_rows) * m_settings.brick_cols);
     for (int row = 0; row < m_settings.brick_rows; row++) 
     {
         for (int col = 0; col < m_settings.brick_cols; col++) 
         {
-            Brick b(
-                col * m_settings.brick_width, 
-                (m_settings.starting_row + row) * m_settings.brick_height, 
-                m_settings.brick_width - m_settings.brick_spacing, 
-                m_settings.brick_height - m_settings.brick_spacing,
-                0,
-                SDL_Color{ 0, 0, 0, 0 }
-            );  // create a new brick
-                
-            if (row % 2 == 0)       // alternate colors and points for each row
-            {
-                b.set_points(10);
-                b.set_color(SDL_Color{ 255, 0, 0, 255 });
-            }
-            else 
-            {
-                b.set_points(20);
-                b.set_color(SDL_Color{ 255, 255, 0, 255 });
-            }
-
-            bricks.push_back(b);
+            const BrickData brick = row_brick(m_settings, row, col);
+            bricks.emplace_back(brick.x, brick.y, brick.width, brick.height, brick.points, SDL_Color(brick.color));
         }
     }
     return bricks;
@@ -0,0 +1,280 @@
+#include <stdexcept>
+#include <string_view>
+#include <charconv>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+#include "SDL.h"
+
+#include "WorkerPool.h"
+#include "AllocationCounter.h"
+
+#include "RunOptions.h"
+
+namespace
+{
+    /**
+     * If arg is "--name=value", store the value and return true.
+     */
+    bool match(std::string_view arg, std::string_view name, std::string_view& value)
+    {
+        if (arg.size() > name.size() && arg.substr(0, name.size()) == name && arg[name.size()] == '=')
+        {
+            value = arg.substr(name.size() + 1);
+            return true;
+        }
+        return false;
+    }
+
+    int to_int(std::string_view arg, std::string_view value)
+    {
+        int result = 0;
+        auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+        if (error != std::errc() || end != value.data() + value.size())
+        {
+            SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Invalid number in argument %s\n", arg.data());
+            throw std::runtime_error("Invalid command line argument\n");
+        }
+        return result;
+    }
+
+    uint64_t to_uint64(std::string_view arg, std::string_view value)
+    {
+        uint64_t result = 0;
+        auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+        if (error != std::errc() || end != value.data() + value.size())
+        {
+            SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Invalid number in argument %s\n", arg.data());
+            throw std::runtime_error("Invalid command line argument\n");
+        }
+        return result;
+    }
+
+    /**
+     * Parse a positive "AxB" pair of numbers.
+     */
+    void to_pair(std::string_view arg, std::string_view value, int& first, int& second)
+    {
+        const size_t separator = value.find('x');
+        if (separator == std::string_view::npos)
+        {
+            SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Expected AxB in argument %s\n", arg.data());
+            throw std::runtime_error("Invalid command line argument\n");
+        }
+        first = to_int(arg, value.substr(0, separator));
+        second = to_int(arg, value.substr(separator + 1));
+        if (first <= 0 || second <= 0)
+        {
+            SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Expected positive numbers in argument %s\n", arg.data());
+            throw std::runtime_error("Invalid command line argument\n");
+        }
+    }
+}
+
+const char* renderer_name(RendererType renderer)
+{
+    switch (renderer)
+    {
+    case RendererType::Accelerated: return "accelerated";
+    case RendererType::Software: return "software";
+    case RendererType::Headless: return "headless";
+    default: return "unknown";
+    }
+}
+
+RunOptions parse_run_options(int argc, char* argv[])
+{
+    RunOptions options;
+    bool seed_given = false;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view arg = argv[i];
+        std::string_view value;
+        if (match(arg, "--renderer", value))
+        {
+            if (value == "accelerated") options.renderer = RendererType::Accelerated;
+            else if (value == "software") options.renderer = RendererType::Software;
+            else if (value == "headless") options.renderer = RendererType::Headless;
+            else
+            {
+                SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Unknown renderer %s\n", argv[i]);
+                throw std::runtime_error("Invalid command line argument\n");
+            }
+        }
+        else if (match(arg, "--pacing", value))
+        {
+            if (value == "steady") options.pacing = FramePacing::Steady;
+            else if (value == "low-latency") options.pacing = FramePacing::LowLatency;
+            else
+            {
+                SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Unknown pacing %s\n", argv[i]);
+                throw std::runtime_error("Invalid command line argument\n");
+            }
+        }
+        else if (match(arg, "--raster-threads", value))
+        {
+            options.raster_threads = to_int(arg, value);
+            if (options.raster_threads <= 0)
+            {
+                options.raster_threads = WorkerPool::hardware_threads();
+            }
+        }
+        else if (match(arg, "--capture", value))
+        {
+            options.capture_path = value;
+        }
+        else if (match(arg, "--capture-ring", value))
+        {
+            options.capture_ring = to_int(arg, value);
+        }
+        else if (match(arg, "--record-input", value))
+        {
+            options.record_input_path = value;
+        }
+        else if (match(arg, "--replay-input", value))
+        {
+            options.replay_input_path = value;
+        }
+        else if (match(arg, "--keyframe-interval", value))
+        {
+            options.keyframe_interval = std::max(1, to_int(arg, value));
+        }
+        else if (match(arg, "--replay-seek", value))
+        {
+            options.replay_seek = std::max(0, to_int(arg, value));
+        }
+        else if (match(arg, "--seed", value))
+        {
+            options.seed = to_uint64(arg, value);
+            seed_given = true;
+        }
+        else if (match(arg, "--export", value))
+        {
+            options.export_path = value;
+        }
+        else if (match(arg, "--export-threads", value))
+        {
+            options.export_threads = to_int(arg, value);
+        }
+        else if (match(arg, "--frame-stats-csv", value))
+        {
+            options.frame_stats_csv_path = value;
+        }
+        else if (match(arg, "--window", value))
+        {
+            to_pair(arg, value, options.window_width, options.window_height);
+        }
+        else if (match(arg, "--layout", value))
+        {
+            to_pair(arg, value, options.layout_rows, options.layout_cols);
+        }
+        else if (match(arg, "--level", value))
+        {
+            options.level_path = value;
+        }
+        else if (match(arg, "--level-pack", value))
+        {
+            options.level_pack_path = value;
+        }
+        else if (arg == "--watch-level")
+        {
+            options.watch_level = true;
+        }
+        else if (match(arg, "--procedural", value))
+        {
+            options.procedural = true;
+            options.procedural_seed = to_uint64(arg, value);
+        }
+        else if (match(arg, "--procedural-density", value))
+        {
+            options.procedural_density = std::clamp(to_int(arg, value), 0, 100);
+        }
+        else if (arg == "--benchmark")
+        {
+            options.benchmark = true;
+        }
+        else if (match(arg, "--benchmark-frames", value))
+        {
+            options.benchmark_frames = static_cast<uint64_t>(std::max(1, to_int(arg, value)));
+        }
+        else if (match(arg, "--benchmark-report", value))
+        {
+            options.benchmark_report_path = value;
+        }
+        else if (arg == "--alloc-check")
+        {
+            options.alloc_check = true;
+        }
+        else if (arg == "--virtual-time")
+        {
+            options.virtual_time = true;
+        }
+        else if (arg == "--no-gamepad")
+        {
+            options.gamepad = false;
+        }
+        else if (match(arg, "--gamepad-deadzone", value))
+        {
+            options.gamepad_deadzone = to_int(arg, value);
+        }
+        else if (arg == "--no-idle")
+        {
+            options.idle_rendering = false;
+        }
+        else
+        {
+            SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Unknown argument %s\n", argv[i]);
+            throw std::runtime_error("Invalid command line argument\n");
+        }
+    }
+
+    if (!options.export_path.empty())
+    {
+        if (options.replay_input_path.empty())
+        {
+            SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "--export needs an input log to replay (--replay-input)\n");
+            throw std::runtime_error("Invalid command line argument\n");
+        }
+        options.renderer = RendererType::Headless;
+        options.virtual_time = true;
+        if (options.export_threads <= 0)
+        {
+            options.export_threads = WorkerPool::hardware_threads();
+        }
+    }
+    if (!options.level_pack_path.empty() && !options.record_input_path.empty())
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "--level-pack can not be recorded (--record-input), a log holds a single level\n");
+        throw std::runtime_error("Invalid command line argument\n");
+    }
+    if (options.watch_level && options.level_path.empty() && options.level_pack_path.empty())
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "--watch-level needs a level file to watch (--level or --level-pack)\n");
+        throw std::runtime_error("Invalid command line argument\n");
+    }
+    if (options.watch_level && !options.record_input_path.empty())
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "--watch-level can not be recorded (--record-input), a log holds a single level\n");
+        throw std::runtime_error("Invalid command line argument\n");
+    }
+    if (options.alloc_check)
+    {
+        if (!allocation_counting_enabled())
+        {
+            SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "--alloc-check needs a build counting the allocations (-DARKANOID_COUNT_ALLOCATIONS=ON)\n");
+            throw std::runtime_error("Invalid command line argument\n");
+        }
+        options.benchmark = true;
+    }
+    if (!seed_given)
+    {
+        // The benchmark must play the same game every run
+        options.seed = options.benchmark ? 1 : (static_cast<uint64_t>(std::random_device{}()) << 32 | std::random_device{}());
+    }
+    if (options.benchmark)
+    {
+        options.virtual_time = true;
+    }
+    return options;
+}
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "SDL.h"
+
+#include "Scheduler.h"
+
+namespace
+{
+    constexpr uint64_t ns_per_second = 1'000'000'000;
+}
+
+int Scheduler::add_task(const char* name, int rate, int max_steps)
+{
+    const int task_rate = std::max(1, rate);
+    m_tasks.push_back(Task{
+        .name = name,
+        .rate = task_rate,
+        .period = ns_per_second / task_rate,
+        .max_steps = std::max(1, max_steps)
+    });
+    return static_cast<int>(m_tasks.size()) - 1;
+}
+
+int Scheduler::due(int task, uint64_t now)
+{
+    Task& t = m_tasks[task];
+    if (t.next == 0)
+    {
+        t.next = now;
+    }
+    if (now < t.next)
+    {
+        return 0;
+    }
+
+    const uint64_t steps = (now - t.next) / t.period + 1;
+    if (steps > static_cast<uint64_t>(t.max_steps))
+    {
+        // Too far behind, run what is allowed and continue from now
+        t.dropped += steps - t.max_steps;
+        t.steps += t.max_steps;
+        t.first_due = now - (t.max_steps - 1) * t.period;
+        t.next = now + t.period;
+        return t.max_steps;
+    }
+    t.steps += steps;
+    t.first_due = t.next;
+    t.next += steps * t.period;
+    return static_cast<int>(steps);
+}
+
+uint64_t Scheduler::get_step_time(int task, int step) const
+{
+    const Task& t = m_tasks[task];
+    return t.first_due + step * t.period;
+}
+
+void Scheduler::resync(uint64_t now)
+{
+    for (auto& task : m_tasks)
+    {
+        task.next = now;
+    }
+}
+
+uint64_t Scheduler::get_steps(int task) const
+{
+    return m_tasks[task].steps;
+}
+
+uint64_t Scheduler::get_dropped(int task) const
+{
+    return m_tasks[task].dropped;
+}
+
+void Scheduler::log_summary() const
+{
+    for (const auto& task : m_tasks)
+    {
+        SDL_Log(
+            "Task %-9s %4d Hz: %llu steps, %llu dropped\n",
+            task.name,
+            task.rate,
+            static_cast<unsigned long long>(task.steps),
+            static_cast<unsigned long long>(task.dropped)
+        );
+    }
+}
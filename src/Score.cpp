@@ -1,7 +1,11 @@
+#include <algorithm>
+#include <cstdio>
 #include <stdexcept>
 #include <memory>
 #include <string_view>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include "SDL.h"
 #include "SDL_ttf.h"
@@ -12,6 +16,7 @@
 Score::Score(std::string_view font_path, int font_size, int num_balls):
     m_points{0},
     m_font_size{font_size},
+    m_current_font_size{font_size},
     m_num_balls{num_balls},
     m_balls_remaining{num_balls}
 {
@@ -31,59 +36,160 @@ Score::Score(std::string_view font_path, int font_size, int num_balls):
 Score::~Score()
 {
     // Same as with screen, need to manually invoke the dtors before TTF_Quit. Order matters.
+    m_atlases.clear();
     if (m_font_ptr) m_font_ptr.reset(nullptr);
-    if (m_text_ptr) m_text_ptr.reset(nullptr);
-    if (m_text_texture_ptr) m_text_texture_ptr.reset(nullptr);
     TTF_Quit();
 }
 
 int Score::get_text_width() const
 {
-    return m_text_ptr->w;
+    return m_text_width;
 }
 
 int Score::get_text_height() const
 {
-    return m_text_ptr->h;
+    return m_text_height;
 }
 
 void Score::draw(Screen& screen, std::optional<int> x, std::optional<int> y)
 {   
-    SDL_Rect dest = {x.value_or(0), y.value_or(screen.height() - get_text_height() - 2), get_text_width(), get_text_height()};
-    SDL_RenderCopy(
-        screen.get_renderer_ptr_raw(), 
-        m_text_texture_ptr.get(), 
-        nullptr, 
-        &dest
-    );
+    if (m_atlas < 0)
+    {
+        return;
+    }
+    const GlyphAtlas& atlas = m_atlases[m_atlas];
+    const int left = x.value_or(0);
+    const int top = y.value_or(screen.height() - get_text_height() - 2);
+    for (size_t i = 0; i < m_glyph_count; i++)
+    {
+        SDL_Rect dest = m_glyphs[i].dest;
+        dest.x += left;
+        dest.y += top;
+        screen.draw_texture(atlas.texture.get(), atlas.surface.get(), dest, RenderLayer::Hud, m_glyphs[i].source);
+    }
 }
 
 void Score::prepare(Screen& screen, const SDL_Color& color)
 {
     char status_string[50] = {0};
-    snprintf(status_string, 50, m_score_format_string, get_points(), get_balls_remaining());
-    m_text_ptr.reset(TTF_RenderText_Solid_Wrapped(m_font_ptr.get(), status_string, color, 0));
-    m_text_texture_ptr.reset(
-        SDL_CreateTextureFromSurface(
-            screen.get_renderer_ptr_raw(), 
-            m_text_ptr.get()
-        )
-    );
+    const int length = snprintf(status_string, 50, m_score_format_string, get_points(), get_balls_remaining());
+    layout_text(screen, std::string_view(status_string, std::clamp(length, 0, 49)), color);
 }
 
 void Score::prepare(Screen& screen, const std::string_view status_string, const SDL_Color& color)
 {
-    m_text_ptr.reset(TTF_RenderText_Solid_Wrapped(m_font_ptr.get(), status_string.data(), color, 0));
-    m_text_texture_ptr.reset(
-        SDL_CreateTextureFromSurface(
-            screen.get_renderer_ptr_raw(), 
-            m_text_ptr.get()
-        )
-    );
+    layout_text(screen, status_string, color);
+}
+
+void Score::layout_text(Screen& screen, const std::string_view text, const SDL_Color& color)
+{
+    m_glyph_count = 0;
+    m_text_width = 0;
+    m_text_height = 0;
+    m_atlas = -1;
+    if (!m_font_ptr)
+    {
+        return;
+    }
+    m_atlas = find_atlas(screen, color);
+    const GlyphAtlas& atlas = m_atlases[m_atlas];
+
+    int pen_x = 0;
+    int pen_y = 0;
+    for (const char c : text.substr(0, max_text_length))
+    {
+        if (c == '\n')
+        {
+            pen_x = 0;
+            pen_y += atlas.line_skip;
+            continue;
+        }
+        const size_t glyph = (c >= first_glyph && c <= last_glyph) ? static_cast<size_t>(c - first_glyph) : static_cast<size_t>('?' - first_glyph);
+        const SDL_Rect& source = atlas.glyphs[glyph];
+        if (source.w > 0)
+        {
+            m_glyphs[m_glyph_count++] = Glyph{source, SDL_Rect{pen_x, pen_y, source.w, source.h}};
+        }
+        pen_x += atlas.advances[glyph];
+        m_text_width = std::max(m_text_width, pen_x);
+    }
+    m_text_height = pen_y + atlas.height;
+}
+
+int Score::find_atlas(Screen& screen, const SDL_Color& color)
+{
+    for (size_t i = 0; i < m_atlases.size(); i++)
+    {
+        const GlyphAtlas& atlas = m_atlases[i];
+        if (atlas.font_size == m_current_font_size && atlas.color.r == color.r && atlas.color.g == color.g
+            && atlas.color.b == color.b && atlas.color.a == color.a)
+        {
+            return static_cast<int>(i);
+        }
+    }
+
+    TTF_Font* font = m_font_ptr.get();
+    GlyphAtlas atlas;
+    atlas.font_size = m_current_font_size;
+    atlas.color = color;
+    atlas.height = TTF_FontHeight(font);
+    atlas.line_skip = TTF_FontLineSkip(font);
+
+    // Render every glyph on its own, then copy them side by side into the atlas
+    std::vector<std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)>> rendered;
+    rendered.reserve(glyph_count);
+    int width = 0;
+    for (size_t i = 0; i < glyph_count; i++)
+    {
+        const Uint16 c = static_cast<Uint16>(first_glyph + i);
+        rendered.emplace_back(TTF_RenderGlyph_Blended(font, c, color), SDL_FreeSurface);
+        const SDL_Surface* glyph = rendered.back().get();
+        const int glyph_width = glyph ? glyph->w : 0;
+        int min_x, max_x, min_y, max_y, advance;
+        if (TTF_GlyphMetrics(font, c, &min_x, &max_x, &min_y, &max_y, &advance) != 0)
+        {
+            advance = glyph_width;
+        }
+        atlas.glyphs[i] = SDL_Rect{width, 0, glyph_width, glyph ? glyph->h : 0};
+        atlas.advances[i] = advance;
+        width += glyph_width;
+        atlas.height = std::max(atlas.height, atlas.glyphs[i].h);
+    }
+
+    atlas.surface.reset(SDL_CreateRGBSurfaceWithFormat(0, std::max(width, 1), std::max(atlas.height, 1), 32, SDL_PIXELFORMAT_ARGB8888));
+    if (!atlas.surface)
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Glyph atlas could not be created! SDL_Error: %s\n", SDL_GetError());
+        throw std::runtime_error("Glyph atlas could not be created!\n");
+    }
+    for (size_t i = 0; i < glyph_count; i++)
+    {
+        if (rendered[i])
+        {
+            // Copy the glyph's alpha as is instead of blending it over the transparent atlas
+            SDL_SetSurfaceBlendMode(rendered[i].get(), SDL_BLENDMODE_NONE);
+            SDL_Rect dest = atlas.glyphs[i];
+            SDL_BlitSurface(rendered[i].get(), nullptr, atlas.surface.get(), &dest);
+        }
+    }
+
+    if (screen.uses_textures())
+    {
+        atlas.texture.reset(SDL_CreateTextureFromSurface(screen.get_renderer_ptr_raw(), atlas.surface.get()));
+        if (!atlas.texture)
+        {
+            SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Glyph atlas texture could not be created! SDL_Error: %s\n", SDL_GetError());
+            throw std::runtime_error("Glyph atlas could not be created!\n");
+        }
+        SDL_SetTextureBlendMode(atlas.texture.get(), SDL_BLENDMODE_BLEND);
+    }
+    m_atlases.push_back(std::move(atlas));
+    return static_cast<int>(m_atlases.size() - 1);
 }
 
 void Score::change_font_size(int new_font_size)
 {
+    m_current_font_size = new_font_size;
     if (m_font_ptr)
     {
         TTF_SetFontSize(m_font_ptr.get(), new_font_size);
@@ -1,22 +1,52 @@
+#include <algorithm>
 #include <stdexcept>
 #include <memory>
 #include <string>
+#include <cstring>
+#include <memory_resource>
 
 #include "SDL.h"
 
+#include "Arena.h"
+#include "RenderCommands.h"
+#include "SoftwareRasterizer.h"
+#include "RunOptions.h"
+
 #include "Screen.h"
 
-Screen::Screen(const std::string_view window_name, int width, int height):
+Screen::Screen(
+    const std::string_view window_name, 
+    int width, 
+    int height, 
+    RendererType renderer_type, 
+    int raster_threads
+):
     m_width{width},
-    m_height{height}
+    m_height{height},
+    m_playfield_width{width},
+    m_playfield_height{height},
+    m_renderer_type{renderer_type}
 {
     SDL_Log("SDL Initialization...\n");
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+    // Display-less machines have no video subsystem, headless runs only need events and timers
+    Uint32 subsystems = renderer_type == RendererType::Headless ? SDL_INIT_EVENTS | SDL_INIT_TIMER : SDL_INIT_VIDEO;
+    if (SDL_Init(subsystems) < 0) {
         SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "SDL could not initialize! SDL_Error: %s \n", SDL_GetError());
         throw std::runtime_error("SDL Library could not be initialized!\n");
     }
     SDL_Log("SDL Initialization OK\n");
 
+    if (renderer_type != RendererType::Accelerated)
+    {
+        SDL_Log("Creating software rasterizer with %d thread(s)...\n", raster_threads);
+        m_rasterizer = std::make_unique<SoftwareRasterizer>(m_width, m_height, raster_threads);
+    }
+    if (renderer_type == RendererType::Headless)
+    {
+        SDL_Log("Running headless, nothing will be presented\n");
+        return;
+    }
+
     SDL_Log("Creating SDL Window ...\n");
     m_window_ptr.reset(SDL_CreateWindow(
         window_name.data(), 
@@ -31,8 +61,10 @@ Screen::Screen(const std::string_view window_name, int width, int height):
     SDL_Log("SDL Window OK\n");
 
     SDL_Log("Creating SDL Renderer ...\n");
+    // The software frame is only uploaded and copied once per frame, any renderer will do for that
+    Uint32 renderer_flags = renderer_type == RendererType::Accelerated ? SDL_RENDERER_ACCELERATED : 0;
     m_renderer_ptr.reset(
-        SDL_CreateRenderer(m_window_ptr.get(), -1, SDL_RENDERER_ACCELERATED)
+        SDL_CreateRenderer(m_window_ptr.get(), -1, renderer_flags)
     );
     if (!m_renderer_ptr) {
         SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Renderer could not be created! SDL_Error: %s \n", SDL_GetError());
@@ -40,20 +72,158 @@ Screen::Screen(const std::string_view window_name, int width, int height):
     }
     SDL_Log("SDL Renderer OK\n");
 
+    if (renderer_type == RendererType::Software)
+    {
+        SDL_Log("Creating streaming texture ...\n");
+        m_stream_texture_ptr.reset(SDL_CreateTexture(
+            m_renderer_ptr.get(), 
+            SDL_PIXELFORMAT_ARGB8888, 
+            SDL_TEXTUREACCESS_STREAMING, 
+            m_width, m_height
+        ));
+        if (!m_stream_texture_ptr) {
+            SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Streaming texture could not be created! SDL_Error: %s \n", SDL_GetError());
+            throw std::runtime_error("Streaming texture could not be created!\n");
+        }
+        SDL_Log("Streaming texture OK\n");
+    }
+
 }
 
 void Screen::clear(SDL_Color clr)
 {
-    // Redraw the screen
-    SDL_SetRenderDrawColor(m_renderer_ptr.get(), clr.r, clr.g, clr.b, clr.a); // Black
+    // Start recording a new frame, the actual clear happens on present. The last frame's memory is free again.
+    m_frame_arena.reset();
+    m_commands.reset();
+    m_clear_color = clr;
+    m_rendered = false;
+}
+
+void Screen::fill_rect(const SDL_Rect& rect, SDL_Color color, RenderLayer layer)
+{
+    m_commands.fill_rect(rect, color, layer);
+}
+
+void Screen::draw_texture(SDL_Texture* texture, SDL_Surface* surface, const SDL_Rect& dest, RenderLayer layer, const SDL_Rect& source)
+{
+    m_commands.textured_quad(texture, surface, dest, layer, source);
+}
+
+void Screen::render()
+{
+    if (m_rendered)
+    {
+        return;
+    }
+    m_rendered = true;
+
+    if (m_rasterizer)
+    {
+        m_commands.sort();
+        m_rasterizer->render(m_commands.data(), m_commands.size(), m_clear_color);
+        m_render_stats = RenderStats{};
+        m_render_stats.commands = static_cast<int>(m_commands.size());
+        m_render_stats.draw_calls = static_cast<int>(m_commands.size());
+        return;
+    }
+
+    if (m_target_texture_ptr)
+    {
+        SDL_SetRenderTarget(m_renderer_ptr.get(), m_target_texture_ptr.get());
+    }
+    SDL_SetRenderDrawColor(m_renderer_ptr.get(), m_clear_color.r, m_clear_color.g, m_clear_color.b, m_clear_color.a);
     SDL_RenderClear(m_renderer_ptr.get());
+    m_render_stats = m_commands.submit(m_renderer_ptr.get(), m_clear_color);
+    m_render_stats.color_changes++;     // the clear color
 }
 
 void Screen::present()
 {
+    render();
+    m_rendered = false;
+
+    if (m_rasterizer)
+    {
+        if (m_stream_texture_ptr)
+        {
+            SDL_UpdateTexture(m_stream_texture_ptr.get(), nullptr, m_rasterizer->pixels(), m_rasterizer->pitch());
+            SDL_RenderCopy(m_renderer_ptr.get(), m_stream_texture_ptr.get(), nullptr, nullptr);
+            SDL_RenderPresent(m_renderer_ptr.get());
+        }
+        return;
+    }
+
+    if (m_target_texture_ptr)
+    {
+        SDL_SetRenderTarget(m_renderer_ptr.get(), nullptr);
+        SDL_RenderCopy(m_renderer_ptr.get(), m_target_texture_ptr.get(), nullptr, nullptr);
+    }
     SDL_RenderPresent(m_renderer_ptr.get());
 }
 
+void Screen::enable_readback()
+{
+    if (m_rasterizer || m_target_texture_ptr)
+    {
+        return;     // the software framebuffer can always be read back
+    }
+    m_target_texture_ptr.reset(SDL_CreateTexture(
+        m_renderer_ptr.get(), 
+        SDL_PIXELFORMAT_ARGB8888, 
+        SDL_TEXTUREACCESS_TARGET, 
+        m_width, m_height
+    ));
+    if (!m_target_texture_ptr) {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Offscreen target could not be created! SDL_Error: %s \n", SDL_GetError());
+        throw std::runtime_error("Offscreen target could not be created!\n");
+    }
+}
+
+bool Screen::read_pixels(uint32_t* pixels, int pitch)
+{
+    if (!m_rendered)
+    {
+        return false;
+    }
+    if (m_rasterizer)
+    {
+        const auto* src = reinterpret_cast<const uint8_t*>(m_rasterizer->pixels());
+        auto* dst = reinterpret_cast<uint8_t*>(pixels);
+        const size_t row_bytes = static_cast<size_t>(m_width) * sizeof(uint32_t);
+        for (int y = 0; y < m_height; y++)
+        {
+            std::memcpy(dst + static_cast<size_t>(y) * pitch, src + static_cast<size_t>(y) * m_rasterizer->pitch(), row_bytes);
+        }
+        return true;
+    }
+    if (!m_target_texture_ptr)
+    {
+        return false;
+    }
+    SDL_Rect area{0, 0, m_width, m_height};
+    return SDL_RenderReadPixels(m_renderer_ptr.get(), &area, SDL_PIXELFORMAT_ARGB8888, pixels, pitch) == 0;
+}
+
+const RenderStats& Screen::get_render_stats() const
+{
+    return m_render_stats;
+}
+
+std::pmr::memory_resource* Screen::get_frame_arena()
+{
+    return &m_frame_arena;
+}
+
+bool Screen::uses_textures() const
+{
+    return m_renderer_type == RendererType::Accelerated;
+}
+
+RendererType Screen::get_renderer_type() const
+{
+    return m_renderer_type;
+}
+
 int Screen::width() const
 {
     return m_width;
@@ -71,7 +241,7 @@ int Screen::left() const
 
 int Screen::right() const
 {
-    return m_width;
+    return m_playfield_width;
 }
 
 int Screen::top() const
@@ -81,11 +251,38 @@ int Screen::top() const
 
 int Screen::bottom() const
 {
-    return m_height;
+    return m_playfield_height;
+}
+
+void Screen::set_playfield(int width, int height)
+{
+    m_playfield_width = std::max(width, m_width);
+    m_playfield_height = std::max(height, m_height);
+    look_at(m_camera_x + m_width / 2, m_camera_y + m_height / 2);
+}
+
+void Screen::look_at(int x, int y)
+{
+    m_camera_x = std::clamp(x - m_width / 2, 0, m_playfield_width - m_width);
+    m_camera_y = std::clamp(y - m_height / 2, 0, m_playfield_height - m_height);
+}
+
+SDL_Rect Screen::get_view() const
+{
+    return SDL_Rect{m_camera_x, m_camera_y, m_width, m_height};
+}
+
+SDL_Rect Screen::to_screen(const SDL_Rect& rect) const
+{
+    return SDL_Rect{rect.x - m_camera_x, rect.y - m_camera_y, rect.w, rect.h};
 }
 
 void Screen::make_resizable()
 {
+    if (!m_window_ptr)
+    {
+        return;
+    }
     SDL_SetWindowResizable(m_window_ptr.get(), SDL_bool::SDL_TRUE);
     SDL_RenderSetLogicalSize(m_renderer_ptr.get(), m_width, m_height);
     SDL_RenderSetIntegerScale(m_renderer_ptr.get(), SDL_bool::SDL_TRUE);
@@ -104,6 +301,8 @@ SDL_Renderer* Screen::get_renderer_ptr_raw()
 Screen::~Screen()
 {
     // Have to mannualy reset the unique_ptr to release the resources before SDL_Quit. Order matters.
+    if (m_target_texture_ptr) m_target_texture_ptr.reset(nullptr);
+    if (m_stream_texture_ptr) m_stream_texture_ptr.reset(nullptr);
     if (m_renderer_ptr) m_renderer_ptr.reset(nullptr);
     if (m_window_ptr) m_window_ptr.reset(nullptr);
     SDL_Quit();
@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+#include "SDL.h"
+
+#include "RenderCommands.h"
+#include "WorkerPool.h"
+
+#include "SoftwareRasterizer.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #include <immintrin.h>
+    #define ARKANOID_AVX2_DISPATCH 1
+#elif defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+namespace
+{
+    using SpanFillFn = void (*)(uint32_t* dst, int count, uint32_t pixel);
+
+    void fill_span_scalar(uint32_t* dst, int count, uint32_t pixel)
+    {
+        std::fill(dst, dst + count, pixel);
+    }
+
+#if defined(ARKANOID_AVX2_DISPATCH) || defined(__AVX2__)
+#if defined(ARKANOID_AVX2_DISPATCH)
+    __attribute__((target("avx2")))
+#endif
+    void fill_span_avx2(uint32_t* dst, int count, uint32_t pixel)
+    {
+        const __m256i value = _mm256_set1_epi32(static_cast<int>(pixel));
+        int i = 0;
+        for (; i + 32 <= count; i += 32)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), value);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 8), value);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 16), value);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 24), value);
+        }
+        for (; i + 8 <= count; i += 8)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), value);
+        }
+        for (; i < count; i++)
+        {
+            dst[i] = pixel;
+        }
+    }
+#endif
+
+    SpanFillFn select_span_fill()
+    {
+#if defined(ARKANOID_AVX2_DISPATCH)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return fill_span_avx2;
+        }
+        return fill_span_scalar;
+#elif defined(__AVX2__)
+        return fill_span_avx2;
+#else
+        return fill_span_scalar;
+#endif
+    }
+
+    const SpanFillFn fill_span = select_span_fill();
+
+    uint32_t to_pixel(SDL_Color color)
+    {
+        return (uint32_t(color.a) << 24) | (uint32_t(color.r) << 16) | (uint32_t(color.g) << 8) | uint32_t(color.b);
+    }
+
+    /**
+     * dst = src * alpha + dst * (1 - alpha) for the three color channels, alpha in [0, 255]. Result is opaque.
+     */
+    uint32_t blend(uint32_t src, uint32_t dst, uint32_t alpha)
+    {
+        uint32_t inv = 255 - alpha;
+        uint32_t rb = ((src & 0x00FF00FF) * alpha + (dst & 0x00FF00FF) * inv + 0x00800080);
+        rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+        uint32_t g = ((src & 0x0000FF00) * alpha + (dst & 0x0000FF00) * inv + 0x00008000);
+        g = ((g + ((g >> 8) & 0x0000FF00)) >> 8) & 0x0000FF00;
+        return 0xFF000000 | rb | g;
+    }
+
+    /**
+     * Clip the rect against the framebuffer columns [0, width) and the band rows [y_begin, y_end).
+     * Returns false if nothing is left.
+     */
+    bool clip(const SDL_Rect& rect, int width, int y_begin, int y_end, int& x0, int& x1, int& y0, int& y1)
+    {
+        x0 = std::max(rect.x, 0);
+        x1 = std::min(rect.x + rect.w, width);
+        y0 = std::max(rect.y, y_begin);
+        y1 = std::min(rect.y + rect.h, y_end);
+        return x0 < x1 && y0 < y1;
+    }
+}
+
+SoftwareRasterizer::SoftwareRasterizer(int width, int height, int threads):
+    m_width{width},
+    m_height{height},
+    m_pixels{std::make_unique<uint32_t[]>(static_cast<size_t>(width) * height)},
+    m_pool{std::max(threads, 1)},
+    m_bands{std::max(threads, 1) == 1 ? 1 : std::max(threads, 1) * 4}  // a few bands per thread to balance the load
+{
+}
+
+void SoftwareRasterizer::render(const RenderCommand* commands, size_t count, SDL_Color clear_color)
+{
+    const uint32_t clear_pixel = to_pixel(clear_color) | 0xFF000000;
+    const int band_height = (m_height + m_bands - 1) / m_bands;
+    m_pool.run(m_bands, [&](int band)
+    {
+        int y_begin = band * band_height;
+        int y_end = std::min(y_begin + band_height, m_height);
+        if (y_begin < y_end)
+        {
+            render_band(y_begin, y_end, commands, count, clear_pixel);
+        }
+    });
+}
+
+void SoftwareRasterizer::render_band(int y_begin, int y_end, const RenderCommand* commands, size_t count, uint32_t clear_pixel)
+{
+    fill_span(m_pixels.get() + static_cast<size_t>(y_begin) * m_width, (y_end - y_begin) * m_width, clear_pixel);
+    for (size_t i = 0; i < count; i++)
+    {
+        const RenderCommand& command = commands[i];
+        if (command.surface)
+        {
+            blit_surface(command.surface, command.source, command.dest, y_begin, y_end);
+        }
+        else if (!command.texture)
+        {
+            fill_rect(command.dest, command.color, y_begin, y_end);
+        }
+    }
+}
+
+void SoftwareRasterizer::fill_rect(const SDL_Rect& rect, SDL_Color color, int y_begin, int y_end)
+{
+    int x0, x1, y0, y1;
+    if (color.a == 0 || !clip(rect, m_width, y_begin, y_end, x0, x1, y0, y1))
+    {
+        return;
+    }
+
+    const uint32_t pixel = to_pixel(color);
+    for (int y = y0; y < y1; y++)
+    {
+        uint32_t* row = m_pixels.get() + static_cast<size_t>(y) * m_width;
+        if (color.a == 255)
+        {
+            fill_span(row + x0, x1 - x0, pixel);
+        }
+        else
+        {
+            for (int x = x0; x < x1; x++)
+            {
+                row[x] = blend(pixel, row[x], color.a);
+            }
+        }
+    }
+}
+
+void SoftwareRasterizer::blit_surface(SDL_Surface* surface, const SDL_Rect& source, const SDL_Rect& dest, int y_begin, int y_end)
+{
+    int x0, x1, y0, y1;
+    if (surface->format->format != SDL_PIXELFORMAT_ARGB8888 || dest.w <= 0 || dest.h <= 0
+        || !clip(dest, m_width, y_begin, y_end, x0, x1, y0, y1))
+    {
+        return;
+    }
+    SDL_Rect area = source.w > 0 ? source : SDL_Rect{0, 0, surface->w, surface->h};
+    const SDL_Rect whole{0, 0, surface->w, surface->h};
+    if (!SDL_IntersectRect(&area, &whole, &area))
+    {
+        return;
+    }
+
+    // 16.16 fixed point steps for the nearest neighbour sampling, 1:1 for the usual unscaled text
+    const int64_t step_x = (int64_t(area.w) << 16) / dest.w;
+    const int64_t step_y = (int64_t(area.h) << 16) / dest.h;
+    const auto* src_pixels = static_cast<const uint8_t*>(surface->pixels) + static_cast<size_t>(area.y) * surface->pitch
+        + static_cast<size_t>(area.x) * sizeof(uint32_t);
+
+    for (int y = y0; y < y1; y++)
+    {
+        const auto* src_row = reinterpret_cast<const uint32_t*>(src_pixels + ((int64_t(y - dest.y) * step_y) >> 16) * surface->pitch);
+        uint32_t* row = m_pixels.get() + static_cast<size_t>(y) * m_width;
+        for (int x = x0; x < x1; x++)
+        {
+            uint32_t src = src_row[(int64_t(x - dest.x) * step_x) >> 16];
+            uint32_t alpha = src >> 24;
+            if (alpha == 255)
+            {
+                row[x] = src;
+            }
+            else if (alpha != 0)
+            {
+                row[x] = blend(src, row[x], alpha);
+            }
+        }
+    }
+}
+
+const uint32_t* SoftwareRasterizer::pixels() const
+{
+    return m_pixels.get();
+}
+
+int SoftwareRasterizer::pitch() const
+{
+    return m_width * static_cast<int>(sizeof(uint32_t));
+}
+
+int SoftwareRasterizer::width() const
+{
+    return m_width;
+}
+
+int SoftwareRasterizer::height() const
+{
+    return m_height;
+}
@@ -0,0 +1,25 @@
+#include <span>
+#include <memory_resource>
+#include <vector>
+
+#include "Brick.h"
+#include "BricksLayout.h"
+
+#include "StaticLayout.h"
+
+
+StaticLayout::StaticLayout(std::span<const BrickData> bricks):
+    m_bricks(bricks)
+{
+}
+
+std::pmr::vector<Brick> StaticLayout::create_bricks(std::pmr::memory_resource* arena)
+{
+    std::pmr::vector<Brick> bricks(arena);
+    bricks.reserve(m_bricks.size());
+    for (const BrickData& brick : m_bricks)
+    {
+        bricks.emplace_back(brick.x, brick.y, brick.width, brick.height, brick.points, SDL_Color(brick.color));
+    }
+    return bricks;
+}
@@ -0,0 +1,36 @@
+#include <string_view>
+#include <memory_resource>
+#include <vector>
+
+#include "SDL.h"
+
+#include "Brick.h"
+#include "TextLevel.h"
+
+#include "TextLayout.h"
+
+TextLayout::TextLayout(const std::string_view path):
+    m_level(parse_text_level(path))
+{
+}
+
+std::pmr::vector<Brick> TextLayout::create_bricks(std::pmr::memory_resource* arena)
+{
+    std::pmr::vector<Brick> bricks(arena);
+    bricks.reserve(m_level.bricks.size());
+    for (const LevelFileBrick& record : m_level.bricks)
+    {
+        bricks.emplace_back(record.x, record.y, record.width, record.height, record.points, SDL_Color(m_level.palette[record.color]));
+    }
+    return bricks;
+}
+
+int TextLayout::get_width() const
+{
+    return static_cast<int>(m_level.width);
+}
+
+int TextLayout::get_height() const
+{
+    return static_cast<int>(m_level.height);
+}
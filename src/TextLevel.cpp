@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "SDL.h"
+
+#include "LevelFile.h"
+
+#include "TextLevel.h"
+
+namespace
+{
+    constexpr int max_line = 4096;
+    constexpr int max_tokens = 5;
+    constexpr int32_t max_coordinate = 1 << 16;
+
+    [[noreturn]] void invalid_level(const std::string_view path, int line, const char* reason)
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Level %s:%d: %s\n", path.data(), line, reason);
+        throw std::runtime_error("Invalid level!\n");
+    }
+
+    bool is_space(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    /**
+     * Split a line into whitespace separated tokens, at most max_tokens of them.
+     *
+     * Returns:
+     * int: number of tokens, max_tokens + 1 if there were more.
+     */
+    int tokenize(std::string_view text, std::string_view (&tokens)[max_tokens])
+    {
+        int count = 0;
+        size_t i = 0;
+        while (true)
+        {
+            while (i < text.size() && is_space(text[i]))
+            {
+                i++;
+            }
+            if (i == text.size())
+            {
+                return count;
+            }
+            if (count == max_tokens)
+            {
+                return max_tokens + 1;
+            }
+            const size_t start = i;
+            while (i < text.size() && !is_space(text[i]))
+            {
+                i++;
+            }
+            tokens[count++] = text.substr(start, i - start);
+        }
+    }
+
+    /**
+     * Parse a whole token as an integer in [min, max].
+     */
+    bool to_int(std::string_view token, int32_t min, int32_t max, int32_t& value, int base = 10)
+    {
+        const auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value, base);
+        return error == std::errc{} && end == token.data() + token.size() && value >= min && value <= max;
+    }
+}
+
+TextLevel parse_text_level(const std::string_view path)
+{
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file{std::fopen(path.data(), "r"), std::fclose};
+    if (!file)
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Could not open %s\n", path.data());
+        throw std::runtime_error("Level could not be opened!\n");
+    }
+
+    TextLevel level;
+    int16_t legend[256];            // palette index of a brick character, -1 if not in the legend
+    uint16_t points[256] = {};
+    std::fill(std::begin(legend), std::end(legend), int16_t(-1));
+    int32_t cell_width = 0, cell_height = 0, spacing = 0, offset_x = 0, offset_y = 0;
+    bool in_grid = false;
+    int row = 0;
+    int line_number = 0;
+    char line[max_line];
+
+    while (std::fgets(line, sizeof(line), file.get()))
+    {
+        line_number++;
+        size_t length = std::strlen(line);
+        if (length == sizeof(line) - 1 && line[length - 1] != '\n' && !std::feof(file.get()))
+        {
+            invalid_level(path, line_number, "line too long");
+        }
+        while (length > 0 && is_space(line[length - 1]))
+        {
+            length--;
+        }
+        std::string_view text(line, length);
+
+        if (in_grid)
+        {
+            const int64_t y = offset_y + int64_t(row) * cell_height;
+            for (size_t column = 0; column < text.size(); column++)
+            {
+                const char cell = text[column];
+                if (cell == '.' || cell == ' ')
+                {
+                    continue;
+                }
+                const int16_t color = legend[static_cast<unsigned char>(cell)];
+                if (color < 0)
+                {
+                    invalid_level(path, line_number, "brick character not in the legend");
+                }
+                const int64_t x = offset_x + int64_t(column) * cell_width;
+                if (x + cell_width - spacing > level.width || y + cell_height - spacing > level.height)
+                {
+                    invalid_level(path, line_number, "brick outside of the playfield");
+                }
+                level.bricks.push_back(LevelFileBrick{
+                    static_cast<int32_t>(x), static_cast<int32_t>(y),
+                    static_cast<uint16_t>(cell_width - spacing), static_cast<uint16_t>(cell_height - spacing),
+                    points[static_cast<unsigned char>(cell)], static_cast<uint8_t>(color), 0
+                });
+            }
+            row++;
+            continue;
+        }
+
+        text = text.substr(0, text.find('#'));
+        std::string_view tokens[max_tokens];
+        const int count = tokenize(text, tokens);
+        if (count == 0)
+        {
+            continue;
+        }
+        const std::string_view directive = tokens[0];
+        if (directive == "size")
+        {
+            int32_t width = 0, height = 0;
+            if (count != 3 || !to_int(tokens[1], 1, max_coordinate, width) || !to_int(tokens[2], 1, max_coordinate, height))
+            {
+                invalid_level(path, line_number, "expected size WIDTH HEIGHT");
+            }
+            level.width = static_cast<uint32_t>(width);
+            level.height = static_cast<uint32_t>(height);
+        }
+        else if (directive == "cell")
+        {
+            if ((count != 3 && count != 4)
+                || !to_int(tokens[1], 1, UINT16_MAX, cell_width)
+                || !to_int(tokens[2], 1, UINT16_MAX, cell_height)
+                || (count == 4 && !to_int(tokens[3], 0, std::min(cell_width, cell_height) - 1, spacing)))
+            {
+                invalid_level(path, line_number, "expected cell WIDTH HEIGHT [SPACING], spacing smaller than the cell");
+            }
+        }
+        else if (directive == "offset")
+        {
+            if (count != 3 || !to_int(tokens[1], 0, max_coordinate, offset_x) || !to_int(tokens[2], 0, max_coordinate, offset_y))
+            {
+                invalid_level(path, line_number, "expected offset X Y");
+            }
+        }
+        else if (directive == "legend")
+        {
+            int32_t rgba = 0, brick_points = 0;
+            const bool has_alpha = count == 4 && tokens[2].size() == 8;
+            if (count != 4
+                || tokens[1].size() != 1
+                || (tokens[2].size() != 6 && !has_alpha)
+                || !to_int(tokens[2].substr(0, 6), 0, 0xFFFFFF, rgba, 16)
+                || !to_int(tokens[3], 0, UINT16_MAX, brick_points))
+            {
+                invalid_level(path, line_number, "expected legend CHARACTER RRGGBB[AA] POINTS");
+            }
+            int32_t alpha = 255;
+            if (has_alpha && !to_int(tokens[2].substr(6), 0, 0xFF, alpha, 16))
+            {
+                invalid_level(path, line_number, "expected legend CHARACTER RRGGBB[AA] POINTS");
+            }
+            const unsigned char character = static_cast<unsigned char>(tokens[1][0]);
+            if (character == '.' || character == '#' || legend[character] >= 0)
+            {
+                invalid_level(path, line_number, "legend character reserved or already defined");
+            }
+            if (level.palette.size() == level_max_palette_size)
+            {
+                invalid_level(path, line_number, "too many legend entries");
+            }
+            legend[character] = static_cast<int16_t>(level.palette.size());
+            points[character] = static_cast<uint16_t>(brick_points);
+            level.palette.push_back(SDL_Color{
+                static_cast<Uint8>(rgba >> 16), static_cast<Uint8>(rgba >> 8), static_cast<Uint8>(rgba), static_cast<Uint8>(alpha)
+            });
+        }
+        else if (directive == "grid")
+        {
+            if (count != 1 || level.width == 0 || cell_width == 0 || level.palette.empty())
+            {
+                invalid_level(path, line_number, "grid needs the size, cell and legend before it");
+            }
+            in_grid = true;
+        }
+        else
+        {
+            invalid_level(path, line_number, "unknown directive");
+        }
+    }
+
+    if (std::ferror(file.get()))
+    {
+        invalid_level(path, line_number, "read error");
+    }
+    if (level.bricks.empty())
+    {
+        invalid_level(path, line_number, "no bricks");
+    }
+    return level;
+}
@@ -0,0 +1,109 @@
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <string_view>
+
+#include "SDL.h"
+
+#include "Screen.h"
+#include "Y4MWriter.h"
+
+#include "VideoCapture.h"
+
+VideoCapture::VideoCapture(const std::string_view path, int width, int height, int fps, int ring_size):
+    m_writer(path, width, height, fps),
+    m_width{width},
+    m_height{height},
+    m_slot_count{ring_size > 0 ? ring_size : 1},
+    m_slots{std::make_unique<Slot[]>(m_slot_count)},
+    m_yuv{std::make_unique<uint8_t[]>(Y4MWriter::frame_size(width, height))}
+{
+    for (int i = 0; i < m_slot_count; i++)
+    {
+        m_slots[i].pixels = std::make_unique<uint32_t[]>(static_cast<size_t>(width) * height);
+    }
+    m_worker = std::thread(&VideoCapture::worker_main, this);
+    SDL_Log("Capturing video to %s (%d frame ring)\n", path.data(), m_slot_count);
+}
+
+VideoCapture::~VideoCapture()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop.store(true, std::memory_order_release);
+    }
+    m_wake_cv.notify_one();
+    m_worker.join();
+    SDL_Log(
+        "Video capture: %llu frames captured, %llu written, %llu dropped\n",
+        static_cast<unsigned long long>(get_captured()),
+        static_cast<unsigned long long>(get_written()),
+        static_cast<unsigned long long>(get_dropped())
+    );
+}
+
+bool VideoCapture::capture(Screen& screen)
+{
+    Slot& slot = m_slots[m_write_index % m_slot_count];
+    if (slot.filled.load(std::memory_order_acquire))
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (!screen.read_pixels(slot.pixels.get(), m_width * static_cast<int>(sizeof(uint32_t))))
+    {
+        return false;
+    }
+
+    slot.filled.store(true, std::memory_order_release);
+    m_write_index++;
+    m_captured.fetch_add(1, std::memory_order_relaxed);
+    m_wake_cv.notify_one();
+    return true;
+}
+
+void VideoCapture::worker_main()
+{
+    while (true)
+    {
+        Slot& slot = m_slots[m_read_index % m_slot_count];
+        if (!slot.filled.load(std::memory_order_acquire))
+        {
+            if (m_stop.load(std::memory_order_acquire))
+            {
+                return;     // everything captured before the stop was written
+            }
+            // The game thread notifies without the lock to never block on it, the timeout covers a missed wakeup
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake_cv.wait_for(lock, std::chrono::milliseconds(5));
+            continue;
+        }
+
+        Y4MWriter::convert(slot.pixels.get(), m_width * static_cast<int>(sizeof(uint32_t)), m_width, m_height, m_yuv.get());
+        slot.filled.store(false, std::memory_order_release);
+        m_read_index++;
+
+        if (m_writer.write_frame(m_yuv.get()))
+        {
+            m_written.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+uint64_t VideoCapture::get_captured() const
+{
+    return m_captured.load(std::memory_order_relaxed);
+}
+
+uint64_t VideoCapture::get_dropped() const
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t VideoCapture::get_written() const
+{
+    return m_written.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,122 @@
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <string_view>
+
+#include "SDL.h"
+
+#include "Screen.h"
+#include "WorkerPool.h"
+#include "Y4MWriter.h"
+
+#include "VideoExporter.h"
+
+VideoExporter::VideoExporter(const std::string_view path, int width, int height, int fps, int threads):
+    m_writer(path, width, height, fps),
+    m_width{width},
+    m_height{height},
+    m_pool{threads},
+    m_batch_size{m_pool.size() * 2}
+{
+    const size_t frame_pixels = static_cast<size_t>(width) * height;
+    for (auto& batch : m_batches)
+    {
+        batch.pixels = std::make_unique<uint32_t[]>(frame_pixels * m_batch_size);
+        batch.yuv = std::make_unique<uint8_t[]>(Y4MWriter::frame_size(width, height) * m_batch_size);
+    }
+    m_writer_thread = std::thread(&VideoExporter::writer_main, this);
+    SDL_Log("Exporting video to %s with %d thread(s)\n", path.data(), m_pool.size());
+}
+
+VideoExporter::~VideoExporter()
+{
+    if (m_batches[m_filling].count > 0)
+    {
+        flush_batch();
+    }
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return m_pending == -1; });
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_writer_thread.join();
+    SDL_Log("Video export: %llu frames\n", static_cast<unsigned long long>(m_frames));
+}
+
+bool VideoExporter::export_frame(Screen& screen)
+{
+    Batch& batch = m_batches[m_filling];
+    uint32_t* frame = batch.pixels.get() + static_cast<size_t>(m_width) * m_height * batch.count;
+    if (!screen.read_pixels(frame, m_width * static_cast<int>(sizeof(uint32_t))))
+    {
+        return false;
+    }
+    batch.count++;
+    m_frames++;
+    if (batch.count == m_batch_size)
+    {
+        flush_batch();
+    }
+    return true;
+}
+
+void VideoExporter::flush_batch()
+{
+    Batch& batch = m_batches[m_filling];
+    const size_t frame_pixels = static_cast<size_t>(m_width) * m_height;
+    const size_t frame_size = Y4MWriter::frame_size(m_width, m_height);
+    m_pool.run(batch.count, [&](int i)
+    {
+        Y4MWriter::convert(
+            batch.pixels.get() + frame_pixels * i,
+            m_width * static_cast<int>(sizeof(uint32_t)),
+            m_width,
+            m_height,
+            batch.yuv.get() + frame_size * i
+        );
+    });
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return m_pending == -1; });   // the other batch must be written before it is refilled
+        m_pending = m_filling;
+    }
+    m_cv.notify_all();
+    m_filling = 1 - m_filling;
+}
+
+void VideoExporter::writer_main()
+{
+    const size_t frame_size = Y4MWriter::frame_size(m_width, m_height);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_cv.wait(lock, [this] { return m_stop || m_pending != -1; });
+        if (m_pending == -1)
+        {
+            return;
+        }
+
+        Batch& batch = m_batches[m_pending];
+        lock.unlock();
+        for (int i = 0; i < batch.count; i++)
+        {
+            if (!m_writer.write_frame(batch.yuv.get() + frame_size * i))
+            {
+                SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Failed to write an exported frame\n");
+            }
+        }
+        batch.count = 0;
+        lock.lock();
+
+        m_pending = -1;
+        m_cv.notify_all();
+    }
+}
+
+uint64_t VideoExporter::get_frames() const
+{
+    return m_frames;
+}
@@ -0,0 +1,103 @@
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(int threads)
+{
+    for (int i = 1; i < threads; i++)
+    {
+        m_threads.emplace_back(&WorkerPool::worker_main, this);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_work_cv.notify_all();
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+void WorkerPool::run_raw(int task_count, TaskFn task, void* context)
+{
+    if (task_count <= 0)
+    {
+        return;
+    }
+    if (m_threads.empty())
+    {
+        for (int i = 0; i < task_count; i++)
+        {
+            task(context, i);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_task = task;
+    m_context = context;
+    m_task_count = task_count;
+    m_next_task = 0;
+    m_unfinished = task_count;
+    m_generation++;
+    m_work_cv.notify_all();
+
+    work(lock);
+    m_done_cv.wait(lock, [this] { return m_unfinished == 0; });
+    m_task = nullptr;
+    m_context = nullptr;
+}
+
+void WorkerPool::work(std::unique_lock<std::mutex>& lock)
+{
+    while (m_task && m_next_task < m_task_count)
+    {
+        int index = m_next_task++;
+        TaskFn task = m_task;
+        void* context = m_context;
+
+        lock.unlock();
+        task(context, index);
+        lock.lock();
+
+        if (--m_unfinished == 0)
+        {
+            m_done_cv.notify_one();
+        }
+    }
+}
+
+void WorkerPool::worker_main()
+{
+    uint64_t seen_generation = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_work_cv.wait(lock, [&] { return m_stop || m_generation != seen_generation; });
+        if (m_stop)
+        {
+            return;
+        }
+        seen_generation = m_generation;
+        work(lock);
+    }
+}
+
+int WorkerPool::size() const
+{
+    return static_cast<int>(m_threads.size()) + 1;
+}
+
+int WorkerPool::hardware_threads()
+{
+    unsigned int threads = std::thread::hardware_concurrency();
+    return threads ? static_cast<int>(threads) : 1;
+}
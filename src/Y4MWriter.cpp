@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string_view>
+
+#include "SDL.h"
+
+#include "Y4MWriter.h"
+
+Y4MWriter::Y4MWriter(const std::string_view path, int width, int height, int fps):
+    m_width{width},
+    m_height{height}
+{
+    m_file.reset(std::fopen(path.data(), "wb"));
+    if (!m_file)
+    {
+        SDL_LogError(SDL_LogCategory::SDL_LOG_CATEGORY_APPLICATION, "Could not open %s for writing\n", path.data());
+        throw std::runtime_error("Video file could not be opened!\n");
+    }
+    std::fprintf(m_file.get(), "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps);
+}
+
+bool Y4MWriter::write_frame(const uint8_t* yuv)
+{
+    static const char frame_header[] = "FRAME\n";
+    const size_t size = frame_size(m_width, m_height);
+    return std::fwrite(frame_header, 1, sizeof(frame_header) - 1, m_file.get()) == sizeof(frame_header) - 1
+        && std::fwrite(yuv, 1, size, m_file.get()) == size;
+}
+
+size_t Y4MWriter::frame_size(int width, int height)
+{
+    const size_t chroma = static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+    return static_cast<size_t>(width) * height + 2 * chroma;
+}
+
+void Y4MWriter::convert(const uint32_t* pixels, int pitch, int width, int height, uint8_t* yuv)
+{
+    const int chroma_width = (width + 1) / 2;
+    const int chroma_height = (height + 1) / 2;
+    uint8_t* y_plane = yuv;
+    uint8_t* u_plane = y_plane + static_cast<size_t>(width) * height;
+    uint8_t* v_plane = u_plane + static_cast<size_t>(chroma_width) * chroma_height;
+    const auto* base = reinterpret_cast<const uint8_t*>(pixels);
+
+    for (int cy = 0; cy < chroma_height; cy++)
+    {
+        const int y0 = cy * 2;
+        const int y1 = y0 + 1 < height ? y0 + 1 : y0;
+        const auto* row0 = reinterpret_cast<const uint32_t*>(base + static_cast<size_t>(y0) * pitch);
+        const auto* row1 = reinterpret_cast<const uint32_t*>(base + static_cast<size_t>(y1) * pitch);
+
+        for (int cx = 0; cx < chroma_width; cx++)
+        {
+            const int x0 = cx * 2;
+            const int x1 = x0 + 1 < width ? x0 + 1 : x0;
+            const uint32_t quad[4] = {row0[x0], row0[x1], row1[x0], row1[x1]};
+
+            int r_sum = 0, g_sum = 0, b_sum = 0;
+            for (int i = 0; i < 4; i++)
+            {
+                const int r = (quad[i] >> 16) & 0xFF;
+                const int g = (quad[i] >> 8) & 0xFF;
+                const int b = quad[i] & 0xFF;
+                r_sum += r;
+                g_sum += g;
+                b_sum += b;
+
+                // Duplicated edge pixels of odd sized frames write the same luma twice
+                const int px = i & 1 ? x1 : x0;
+                const int py = i & 2 ? y1 : y0;
+                y_plane[static_cast<size_t>(py) * width + px] = static_cast<uint8_t>((77 * r + 150 * g + 29 * b + 128) >> 8);
+            }
+
+            const int r = (r_sum + 2) >> 2;
+            const int g = (g_sum + 2) >> 2;
+            const int b = (b_sum + 2) >> 2;
+            const size_t chroma_index = static_cast<size_t>(cy) * chroma_width + cx;
+            u_plane[chroma_index] = static_cast<uint8_t>(std::clamp(((-43 * r - 85 * g + 128 * b + 128) >> 8) + 128, 0, 255));
+            v_plane[chroma_index] = static_cast<uint8_t>(std::clamp(((128 * r - 107 * g - 21 * b + 128) >> 8) + 128, 0, 255));
+        }
+    }
+}
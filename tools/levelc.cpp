@@ -0,0 +1,64 @@
+/**
+ * levelc
+ *
+ * Offline level compiler. Validates text levels (see TextLevel.h) and compiles them into the binary format loaded
+ * by BinaryLevelLayout, so the game never parses text at startup.
+ *
+ * Usage:
+ *  levelc LEVEL.txt OUTPUT.arkl    validate and compile
+ *  levelc --check LEVEL.txt...     only validate
+ *
+ * Exits with 0 when every level was valid (and written), 1 otherwise. The problems are logged with their line.
+ */
+
+#include <cstdio>
+#include <stdexcept>
+#include <string_view>
+
+#define SDL_MAIN_HANDLED    // a plain console program, no SDL_main
+#include "SDL.h"
+
+#include "LevelFile.h"
+#include "TextLevel.h"
+
+
+int main(int argc, char* argv[])
+{
+    if (argc >= 3 && std::string_view(argv[1]) == "--check")
+    {
+        int failed = 0;
+        for (int i = 2; i < argc; i++)
+        {
+            try
+            {
+                const TextLevel level = parse_text_level(argv[i]);
+                SDL_Log("%s: %zu bricks, %zu colors, %ux%u\n", argv[i], level.bricks.size(), level.palette.size(), level.width, level.height);
+            }
+            catch (const std::runtime_error&)
+            {
+                failed++;
+            }
+        }
+        return failed == 0 ? 0 : 1;
+    }
+    if (argc != 3)
+    {
+        std::fprintf(stderr, "Usage: %s LEVEL.txt OUTPUT.arkl\n       %s --check LEVEL.txt...\n", argv[0], argv[0]);
+        return 1;
+    }
+
+    try
+    {
+        const TextLevel level = parse_text_level(argv[1]);
+        write_level_file(argv[2], level.width, level.height, level.palette, level.bricks);
+        SDL_Log(
+            "%s -> %s: %zu bricks, %zu colors, %ux%u\n",
+            argv[1], argv[2], level.bricks.size(), level.palette.size(), level.width, level.height
+        );
+    }
+    catch (const std::runtime_error&)
+    {
+        return 1;
+    }
+    return 0;
+}